@@ -0,0 +1,214 @@
+#include "audio.h"
+
+// Sample playback; only in 'make AUDIO=1' builds.
+#ifdef VVC_AUDIO
+#include "audio_clip_birds.h"
+
+static void audio_start(void);
+static void audio_fill(volatile unsigned char* buf);
+static int audio_decode(unsigned int nibble);
+
+// IMA ADPCM step sizes, and step index changes per code.
+static const unsigned short audio_adpcm_steps[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+    41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+    190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+    6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289,
+    16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+static const signed char audio_adpcm_index_adj[8] = {
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+// One cycle of a sine wave, signed.
+static const signed char audio_wave[AUDIO_WAVE_SIZE] = {
+    0, 25, 49, 71, 90, 106, 117, 125, 127, 125, 117, 106, 90, 71, 49, 25,
+    0, -25, -49, -71, -90, -106, -117, -125, -127, -125, -117, -106, -90,
+    -71, -49, -25
+};
+
+const audio_clip_t audio_clip_birds = {
+    audio_clip_birds_data, AUDIO_CLIP_BIRDS_SAMPLES
+};
+
+// DMA ring buffer; read by DMA1 channel 1, written in its interrupt.
+static volatile unsigned char audio_ring[AUDIO_RING_SIZE];
+static volatile audio_t audio;
+
+/*
+ * Play an ADPCM clip, once or over and over.
+ */
+void audio_play_clip(const audio_clip_t* clip, int loop) {
+    audio_stop();
+    audio.clip = clip;
+    audio.pos = 0;
+    audio.predictor = 0;
+    audio.index = 0;
+    audio.loop = loop;
+    audio.mode = AUDIO_CLIP;
+    audio_start();
+}
+
+/*
+ * Start the wavetable oscillator, silent until 'audio_wave_period'
+ * gives it a note.
+ */
+void audio_play_wave(void) {
+    audio_stop();
+    audio.phase = 0;
+    audio.phase_step = 0;
+    audio.mode = AUDIO_WAVE;
+    audio_start();
+}
+
+/*
+ * Retune the oscillator to a buzzer timer period (see buzzer.h), or
+ * silence it with a period of 0. Cheap enough to call per note.
+ * (This is the one division; the sample loop has none.)
+ */
+void audio_wave_period(unsigned int period) {
+    audio.phase_step = period ? (AUDIO_STEP_PER_PERIOD / period) : 0;
+}
+
+/*
+ * Stop playback, and hand TIM2 back to the buzzer.
+ */
+void audio_stop(void) {
+    if (audio.mode == AUDIO_IDLE) { return; }
+    audio.mode = AUDIO_IDLE;
+    AUDIO_RATE_TIM->CR1 = 0;
+    AUDIO_DMA_CHAN->CCR = 0;
+    buzzer_init();
+}
+
+int audio_playing(void) {
+    return audio.mode != AUDIO_IDLE;
+}
+
+/*
+ * Take over TIM2 as an 8-bit PWM output, fill the whole ring buffer,
+ * and start the sample clock.
+ */
+static void audio_start(void) {
+    buzzer_stop();
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM17, ENABLE);
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    audio.draining = 0;
+    audio_fill(&audio_ring[0]);
+    audio_fill(&audio_ring[AUDIO_HALF_SIZE]);
+
+    // (The buzzer already set up channel 4 in preloaded PWM mode.)
+    AUDIO_PWM_TIM->PSC  = 0;
+    AUDIO_PWM_TIM->ARR  = AUDIO_PWM_PERIOD - 1;
+    AUDIO_PWM_TIM->CCR4 = AUDIO_MIDPOINT;
+    AUDIO_PWM_TIM->EGR  = TIM_EGR_UG;
+
+    // Byte-wide reads from the ring, word-wide writes to CCR4.
+    AUDIO_DMA_CHAN->CCR   = 0;
+    AUDIO_DMA_CHAN->CPAR  = (unsigned int)&AUDIO_PWM_TIM->CCR4;
+    AUDIO_DMA_CHAN->CMAR  = (unsigned int)audio_ring;
+    AUDIO_DMA_CHAN->CNDTR = AUDIO_RING_SIZE;
+    AUDIO_DMA_CHAN->CCR   = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_CIRC |
+                            DMA_CCR_PSIZE_1 | DMA_CCR_HTIE | DMA_CCR_TCIE;
+    // (Refills take ~100us; the direct-drive scan must not wait on them.)
+    NVIC_SetPriority(AUDIO_DMA_IRQn, 1);
+    NVIC_EnableIRQ(AUDIO_DMA_IRQn);
+    AUDIO_DMA_CHAN->CCR  |= DMA_CCR_EN;
+
+    AUDIO_RATE_TIM->CR1  = 0;
+    AUDIO_RATE_TIM->PSC  = 0;
+    AUDIO_RATE_TIM->ARR  = (48000000 / AUDIO_SAMPLE_HZ) - 1;
+    AUDIO_RATE_TIM->DIER = TIM_DIER_UDE;
+    AUDIO_RATE_TIM->EGR  = TIM_EGR_UG;
+    AUDIO_RATE_TIM->CR1  = TIM_CR1_CEN;
+}
+
+/*
+ * DMA1 channel 1 interrupt: half of the ring has played; refill it.
+ * A finished clip plays out one more ring of silence (so its tail
+ * isn't cut off) before playback stops.
+ */
+void DMA1_chan1_IRQ_handler(void) {
+    unsigned int isr = DMA1->ISR;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    if (isr & DMA_ISR_HTIF1) {
+        audio_fill(&audio_ring[0]);
+    }
+    if (isr & DMA_ISR_TCIF1) {
+        audio_fill(&audio_ring[AUDIO_HALF_SIZE]);
+    }
+    if (audio.draining && !--audio.draining) {
+        audio_stop();
+    }
+}
+
+/*
+ * Fill half of the ring buffer with output levels.
+ */
+static void audio_fill(volatile unsigned char* buf) {
+    // (The buzzer's volume and crescendo scale the amplitude.)
+    unsigned int scale = buzzer_volume_scale();
+    int i;
+    if (audio.mode == AUDIO_CLIP && !audio.draining) {
+        const unsigned char* data = audio.clip->data;
+        unsigned int pos = audio.pos;
+        for (i = 0; i < AUDIO_HALF_SIZE; ++i) {
+            int sample = 0;
+            if (pos >= audio.clip->samples) {
+                if (audio.loop) {
+                    pos = 0;
+                    audio.predictor = 0;
+                    audio.index = 0;
+                }
+                else if (!audio.draining) {
+                    audio.draining = 3;
+                }
+            }
+            if (!audio.draining) {
+                sample = audio_decode(data[pos >> 1] >> ((pos & 0x01) * 4));
+                ++pos;
+            }
+            // (16-bit sample -> +/-127)
+            buf[i] = AUDIO_MIDPOINT + (((sample >> 8) * (int)scale) >> 8);
+        }
+        audio.pos = pos;
+    }
+    else if (audio.mode == AUDIO_WAVE && audio.phase_step) {
+        unsigned short phase = audio.phase;
+        for (i = 0; i < AUDIO_HALF_SIZE; ++i) {
+            int sample = audio_wave[phase >> 11];
+            buf[i] = AUDIO_MIDPOINT + ((sample * (int)scale) >> 8);
+            phase += audio.phase_step;
+        }
+        audio.phase = phase;
+    }
+    else {
+        for (i = 0; i < AUDIO_HALF_SIZE; ++i) {
+            buf[i] = AUDIO_MIDPOINT;
+        }
+    }
+}
+
+/*
+ * Decode one 4-bit IMA ADPCM code into a 16-bit sample.
+ */
+static int audio_decode(unsigned int nibble) {
+    int step = audio_adpcm_steps[audio.index];
+    int diff = step >> 3;
+    if (nibble & 0x01) { diff += step >> 2; }
+    if (nibble & 0x02) { diff += step >> 1; }
+    if (nibble & 0x04) { diff += step; }
+    int predictor = audio.predictor;
+    if (nibble & 0x08) { predictor -= diff; }
+    else { predictor += diff; }
+    if (predictor > 32767) { predictor = 32767; }
+    if (predictor < -32768) { predictor = -32768; }
+    audio.predictor = predictor;
+    int index = audio.index + audio_adpcm_index_adj[nibble & 0x07];
+    if (index < 0) { index = 0; }
+    if (index > 88) { index = 88; }
+    audio.index = index;
+    return predictor;
+}
+#endif
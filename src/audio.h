@@ -0,0 +1,83 @@
+#ifndef _VVC_AUDIO_H
+#define _VVC_AUDIO_H
+
+#include "global.h"
+#include "buzzer.h"
+
+// Sample playback on the buzzer pin. (Build with 'make AUDIO=1')
+// TIM2 turns PA3 into an 8-bit PWM 'DAC' at 187.5KHz, which an RC
+// low-pass filter smooths into audio. TIM17's update event fires at
+// the sample rate, and DMA1 channel 1 copies the next sample from a
+// ring buffer into TIM2's compare register each time. The DMA half-
+// and full-transfer interrupts refill whichever half just played,
+// either by decoding an ADPCM clip or from a wavetable oscillator.
+// (Clips are made from WAV files by tools/wav2adpcm.py.)
+//
+// Cost: ~40 cycles per decoded sample, or ~320K cycles/s at 8KHz;
+// well under 1% of the CPU. The transfers themselves are all DMA.
+//
+// The buzzer module owns TIM2 the rest of the time; playback takes
+// it over, and hands it back when it stops. The buzzer's volume (and
+// crescendo) still applies, as the amplitude.
+#ifdef VVC_AUDIO
+#if !defined(STM32F031)
+#error "VVC_AUDIO needs TIM2's channel on PA3; build for an STM32F031."
+#endif
+#define AUDIO_SAMPLE_HZ         8000
+#define AUDIO_PWM_TIM           TIM2
+#define AUDIO_PWM_PERIOD        256
+#define AUDIO_RATE_TIM          TIM17
+// (TIM17_UP is mapped to DMA1 channel 1 by default.)
+#define AUDIO_DMA_CHAN          DMA1_Channel1
+#define AUDIO_DMA_IRQn          DMA1_Channel1_IRQn
+// Ring buffer: 2 halves of 16ms each.
+#define AUDIO_RING_SIZE         256
+#define AUDIO_HALF_SIZE         (AUDIO_RING_SIZE / 2)
+// Wavetable: one cycle of a sine wave.
+#define AUDIO_WAVE_SIZE         32
+// Output level for silence.
+#define AUDIO_MIDPOINT          128
+// Oscillator phase step per buzzer timer period, for tones.
+// (65536 * (BUZZER_TIMER_HZ / period) / AUDIO_SAMPLE_HZ)
+#define AUDIO_STEP_PER_PERIOD   ((BUZZER_TIMER_HZ / AUDIO_SAMPLE_HZ) * 65536)
+
+// What is being played.
+#define AUDIO_IDLE              0
+#define AUDIO_CLIP              1
+#define AUDIO_WAVE              2
+
+// A clip: 4-bit IMA ADPCM at AUDIO_SAMPLE_HZ, two samples per byte
+// (low nibble first), decoded from a predictor and step index of 0.
+typedef struct {
+    const unsigned char* data;
+    unsigned int samples;
+} audio_clip_t;
+
+typedef struct {
+    unsigned char  mode;
+    unsigned char  loop;
+    // Halves of silence left to play before stopping.
+    unsigned char  draining;
+    // Clip decoder state.
+    const audio_clip_t* clip;
+    unsigned int   pos;
+    int            predictor;
+    int            index;
+    // Wavetable oscillator: 16-bit phase, and per-sample step.
+    // (A step of 0 is silence.)
+    unsigned short phase;
+    unsigned short phase_step;
+} audio_t;
+
+// Built-in clips.
+extern const audio_clip_t audio_clip_birds;
+
+void audio_play_clip(const audio_clip_t* clip, int loop);
+void audio_play_wave(void);
+void audio_wave_period(unsigned int period);
+void audio_stop(void);
+int audio_playing(void);
+void DMA1_chan1_IRQ_handler(void);
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef _VVC_AUDIO_CLIP_BIRDS_H
+#define _VVC_AUDIO_CLIP_BIRDS_H
+
+// Generated by tools/wav2adpcm.py from birds.wav.
+// 3600 samples at 8000Hz, 4-bit IMA ADPCM.
+#define AUDIO_CLIP_BIRDS_SAMPLES 3600
+static const unsigned char audio_clip_birds_data[1800] = {
+    0x00, 0x09, 0xA7, 0x5F, 0xF2, 0x68, 0xC9, 0x33, 0x9F, 0x85, 0x2C, 0xC4,
+    0x5A, 0xC0, 0x41, 0xBB, 0x06, 0x1C, 0xB3, 0x6B, 0xC0, 0x40, 0xAA, 0x14,
+    0x0D, 0xA4, 0x4A, 0xD0, 0x31, 0xAB, 0x86, 0x2B, 0xC2, 0x58, 0xB9, 0x23,
+    0x0E, 0xA3, 0x6B, 0xB8, 0x32, 0x8D, 0x94, 0x4B, 0xC0, 0x31, 0x8C, 0x94,
+    0x4B, 0xC0, 0x31, 0x8C, 0xA4, 0x4A, 0xC0, 0x22, 0x0D, 0xB3, 0x59, 0xA9,
+    0x03, 0x2C, 0xD2, 0x30, 0x9B, 0x96, 0x3A, 0xD0, 0x12, 0x1C, 0xC3, 0x48,
+    0x9A, 0x94, 0x4B, 0xC0, 0x12, 0x1C, 0xD3, 0x30, 0x8B, 0xA4, 0x49, 0xB9,
+    0x85, 0x3B, 0xC0, 0x03, 0x2D, 0xC1, 0x22, 0x1D, 0xC2, 0x30, 0x8B, 0xB5,
+    0x48, 0x9A, 0xA4, 0x49, 0x9A, 0x94, 0x4A, 0xA9, 0x94, 0x4A, 0xA9, 0x94,
+    0x5A, 0xB9, 0x95, 0x5B, 0xB9, 0x95, 0x5B, 0xA9, 0xA5, 0x5A, 0xAA, 0xB6,
+    0x59, 0x9B, 0xC6, 0x58, 0x0C, 0xD4, 0x31, 0x1D, 0xE3, 0x13, 0x3D, 0xD0,
+    0x84, 0x5C, 0xB9, 0xA5, 0x6A, 0x8B, 0xC4, 0x31, 0x2E, 0xD2, 0x03, 0x4D,
+    0xB8, 0xA5, 0x6A, 0x0C, 0xD4, 0x22, 0x4E, 0xC8, 0xA5, 0x6A, 0x0C, 0xD4,
+    0x22, 0x4E, 0xB8, 0xA5, 0x59, 0x0C, 0xD3, 0x03, 0x4D, 0xA9, 0xB5, 0x30,
+    0x3E, 0xC0, 0xA4, 0x59, 0x1C, 0xD2, 0x83, 0x6B, 0x8B, 0xC4, 0x12, 0x4C,
+    0x9A, 0xB4, 0x11, 0x4C, 0x9A, 0xB4, 0x21, 0x3D, 0x99, 0xB4, 0x11, 0x4C,
+    0x99, 0xC3, 0x02, 0x4C, 0x8A, 0xC3, 0x82, 0x4A, 0x0A, 0xD2, 0x93, 0x49,
+    0x2C, 0xB0, 0xA4, 0x10, 0x4B, 0x99, 0xC3, 0x82, 0x5A, 0x1B, 0xB1, 0xA4,
+    0x38, 0x3D, 0x8A, 0xC3, 0x93, 0x39, 0x2C, 0xA8, 0xB5, 0x82, 0x4A, 0x1B,
+    0xC1, 0xA4, 0x01, 0x4B, 0x0A, 0xB1, 0xB5, 0x11, 0x4B, 0x1B, 0xB1, 0xB5,
+    0x01, 0x4A, 0x2B, 0xA8, 0xB4, 0x82, 0x39, 0x3C, 0x8A, 0xD3, 0xA3, 0x20,
+    0x3C, 0x1A, 0xB0, 0xB5, 0x82, 0x39, 0x3C, 0x0A, 0xB1, 0xB4, 0x82, 0x4A,
+    0x2B, 0x09, 0xB1, 0xA4, 0x81, 0x29, 0x3B, 0x1A, 0xA0, 0xB3, 0x82, 0x08,
+    0x19, 0x08, 0x08, 0x08, 0x08, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x88,
+    0x80, 0x80, 0x80, 0x00, 0x08, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3B, 0xF7, 0x71,
+    0x9C, 0x97, 0x5C, 0xD0, 0x32, 0x0F, 0xB4, 0x6A, 0xC8, 0x13, 0x1D, 0xD3,
+    0x40, 0x9B, 0x95, 0x5B, 0xC8, 0x13, 0x1D, 0xD3, 0x30, 0x9B, 0xA6, 0x49,
+    0xB9, 0x04, 0x2C, 0xE2, 0x21, 0x1C, 0xB2, 0x58, 0x8B, 0xA5, 0x49, 0xAA,
+    0x95, 0x4A, 0xA9, 0x84, 0x4B, 0xC8, 0x03, 0x3C, 0xC0, 0x03, 0x3D, 0xC0,
+    0x12, 0x2D, 0xC1, 0x12, 0x2C, 0xD1, 0x12, 0x3C, 0xB8, 0x84, 0x4B, 0xC8,
+    0x94, 0x4A, 0x99, 0xA3, 0x59, 0x9A, 0xB4, 0x40, 0x0C, 0xC3, 0x21, 0x2D,
+    0xC1, 0x02, 0x4B, 0xA9, 0xA5, 0x49, 0x8A, 0xC3, 0x21, 0x2D, 0xD1, 0x84,
+    0x4B, 0xA9, 0xB5, 0x30, 0x1D, 0xD2, 0x83, 0x6B, 0x9A, 0xC4, 0x31, 0x3E,
+    0xC0, 0xA4, 0x59, 0x1C, 0xE3, 0x03, 0x4C, 0x9A, 0xC5, 0x21, 0x4E, 0xB8,
+    0xC6, 0x40, 0x3D, 0xD0, 0xB5, 0x58, 0x3D, 0xD0, 0xB5, 0x58, 0x3D, 0xD0,
+    0xB5, 0x58, 0x3D, 0xB8, 0xC6, 0x31, 0x4E, 0xA9, 0xC5, 0x02, 0x5C, 0x8B,
+    0xD4, 0x94, 0x5A, 0x2C, 0xC0, 0xC5, 0x21, 0x4D, 0x8A, 0xD4, 0x94, 0x5A,
+    0x2C, 0xB0, 0xC6, 0x02, 0x4C, 0x1B, 0xC1, 0xB4, 0x21, 0x4D, 0x1B, 0xC1,
+    0xB4, 0x11, 0x4C, 0x0A, 0xC1, 0xA4, 0x10, 0x5B, 0x1B, 0xB1, 0xB4, 0x82,
+    0x5A, 0x2C, 0x98, 0xC3, 0xA3, 0x20, 0x3D, 0x1A, 0xB0, 0xB5, 0x82, 0x39,
+    0x3D, 0x0A, 0xB1, 0xB5, 0x82, 0x39, 0x3D, 0x1A, 0xB0, 0xB5, 0x92, 0x38,
+    0x3D, 0x2B, 0x98, 0xC4, 0xA3, 0x81, 0x39, 0x3D, 0x1A, 0xA0, 0xC3, 0xA3,
+    0x01, 0x5B, 0x3C, 0x1A, 0x98, 0xC3, 0xB3, 0x82, 0x39, 0x3C, 0x3B, 0x0A,
+    0xB1, 0xC4, 0xA3, 0x81, 0x28, 0x3B, 0x3C, 0x1A, 0x88, 0xA1, 0xB3, 0x92,
+    0x00, 0x29, 0x3B, 0x1A, 0x19, 0x88, 0x80, 0x00, 0x08, 0x08, 0x88, 0x00,
+    0x88, 0x80, 0x80, 0x80, 0x80, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x09,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x7A, 0x5E, 0x2B, 0xE0, 0xC7, 0xA3, 0x30, 0x5F, 0x2C, 0x89,
+    0xD4, 0xB4, 0x82, 0x7B, 0x3C, 0x0A, 0xD2, 0xB4, 0x82, 0x6A, 0x3C, 0x0A,
+    0xD2, 0xB4, 0x82, 0x5A, 0x3C, 0x8A, 0xD3, 0xB4, 0x02, 0x5C, 0x2B, 0xA8,
+    0xC4, 0xA3, 0x20, 0x4D, 0x0A, 0xB1, 0xB5, 0x82, 0x6B, 0x3B, 0xA9, 0xC5,
+    0xA3, 0x38, 0x4D, 0x0A, 0xC1, 0xA4, 0x10, 0x5B, 0x1B, 0xB1, 0xB5, 0x11,
+    0x4C, 0x2B, 0xB0, 0xB5, 0x82, 0x6B, 0x2B, 0xB0, 0xB5, 0x01, 0x6B, 0x2B,
+    0xB0, 0xB5, 0x11, 0x4C, 0x0A, 0xC1, 0xA4, 0x20, 0x3C, 0x8A, 0xC4, 0xA3,
+    0x38, 0x3D, 0xA9, 0xB5, 0x02, 0x4C, 0x0A, 0xB1, 0xA5, 0x38, 0x3D, 0x99,
+    0xC3, 0x02, 0x5B, 0x1B, 0xC1, 0xA4, 0x38, 0x3D, 0x99, 0xB4, 0x11, 0x4C,
+    0x8A, 0xD3, 0x93, 0x5A, 0x1B, 0xC1, 0xA4, 0x38, 0x2C, 0xC0, 0xA4, 0x38,
+    0x3D, 0xB8, 0xB5, 0x21, 0x3D, 0xA9, 0xB5, 0x21, 0x3D, 0xA9, 0xC6, 0x21,
+    0x4D, 0xA9, 0xC5, 0x21, 0x4D, 0xA9, 0xC5, 0x21, 0x3D, 0xB8, 0xB6, 0x48,
+    0x3C, 0xD0, 0xB5, 0x48, 0x2C, 0xD1, 0x94, 0x5A, 0x8B, 0xC4, 0x12, 0x4D,
+    0xA9, 0xC5, 0x31, 0x3E, 0xC0, 0xA4, 0x59, 0x1C, 0xE3, 0x03, 0x5D, 0xAA,
+    0xC6, 0x40, 0x2D, 0xE2, 0x84, 0x5B, 0x9A, 0xC5, 0x40, 0x3D, 0xD0, 0x84,
+    0x5B, 0x9A, 0xC5, 0x40, 0x2D, 0xE2, 0x84, 0x5C, 0xAA, 0xB6, 0x59, 0x1C,
+    0xE3, 0x22, 0x4E, 0xC8, 0x95, 0x5B, 0x9A, 0xC5, 0x40, 0x0C, 0xD4, 0x22,
+    0x3E, 0xD1, 0x84, 0x4C, 0xA9, 0xA5, 0x5A, 0x9A, 0xC5, 0x40, 0x0C, 0xC3,
+    0x21, 0x2D, 0xD2, 0x12, 0x3D, 0xD1, 0x03, 0x3C, 0xC8, 0x84, 0x4B, 0xA9,
+    0x94, 0x4A, 0xA9, 0xA5, 0x5A, 0x9A, 0xA4, 0x49, 0x9A, 0xA5, 0x49, 0x9A,
+    0xA4, 0x49, 0x9A, 0xA4, 0x49, 0xA9, 0x94, 0x4A, 0xA9, 0x94, 0x4A, 0xA9,
+    0x94, 0x4A, 0xB8, 0x84, 0x3B, 0xC0, 0x03, 0x2C, 0xC1, 0x12, 0x1C, 0xC2,
+    0x21, 0x0B, 0xC3, 0x48, 0x9A, 0xA4, 0x49, 0xA9, 0x94, 0x3A, 0xC0, 0x12,
+    0x2C, 0xC1, 0x21, 0x0B, 0xB4, 0x59, 0x9A, 0x94, 0x3A, 0xB8, 0x13, 0x1D,
+    0xC2, 0x40, 0x8B, 0xA4, 0x39, 0xC8, 0x03, 0x2C, 0xC2, 0x30, 0x9B, 0xA5,
+    0x39, 0xB8, 0x13, 0x1D, 0xB2, 0x58, 0x9A, 0x83, 0x3C, 0xB0, 0x31, 0x8C,
+    0xA4, 0x4A, 0xB8, 0x13, 0x1C, 0xC3, 0x38, 0xB9, 0x04, 0x1C, 0xC3, 0x38,
+    0xA9, 0x03, 0x2C, 0xC2, 0x48, 0x9A, 0x83, 0x2B, 0xC2, 0x48, 0xA9, 0x03,
+    0x1C, 0xA2, 0x39, 0xB8, 0x22, 0x0C, 0xA3, 0x3A, 0xC0, 0x31, 0x9B, 0x94,
+    0x2A, 0xA1, 0x38, 0x9A, 0x02, 0x0A, 0x92, 0x19, 0x90, 0x00, 0x08, 0x08,
+    0x08, 0x08, 0x88, 0x00, 0x08, 0x08, 0x08, 0x88, 0x80, 0x80, 0x90, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "bcd.h"
+
+/*
+ * Increment a BCD value, wrapping to 0 when it reaches 'wrap'.
+ * (For example, 'wrap' is 0x24 for hours and 0x60 for minutes.)
+ */
+unsigned char bcd_inc(unsigned char v, unsigned char wrap) {
+    ++v;
+    // '9' + 1 = 0x?A; carry into the tens digit.
+    if ((v & 0x0F) == 0x0A) { v += 0x06; }
+    if (v >= wrap) { v = 0x00; }
+    return v;
+}
+
+/*
+ * Decrement a BCD value, wrapping from 0 to 'wrap' - 1.
+ */
+unsigned char bcd_dec(unsigned char v, unsigned char wrap) {
+    if (v == 0x00) { v = wrap; }
+    // 'x0' - 1 = 'x-1 9'; borrow from the tens digit.
+    if ((v & 0x0F) == 0x00) { return v - 0x07; }
+    return v - 1;
+}
+
+/*
+ * Add 10 to a BCD value, wrapping around at 'wrap'. Only the tens
+ * digit changes, so 'wrap' has to be a multiple of ten (like
+ * BCD_WRAP_MINUTES) for this to stay in range.
+ */
+unsigned char bcd_inc_tens(unsigned char v, unsigned char wrap) {
+    v += 0x10;
+    if (v >= wrap) { v -= wrap; }
+    return v;
+}
+
+/*
+ * Subtract 10 from a BCD value, wrapping around at 'wrap'.
+ * (Same limits as 'bcd_inc_tens'.)
+ */
+unsigned char bcd_dec_tens(unsigned char v, unsigned char wrap) {
+    if (v < 0x10) { v += wrap; }
+    return v - 0x10;
+}
+
+/*
+ * Add two 2-digit BCD values. The result is returned mod 100, and
+ * 'carry' (if not null) is set to 1 if it overflowed past 99.
+ */
+unsigned char bcd_add(unsigned char a, unsigned char b,
+                      unsigned char* carry) {
+    unsigned int sum = a + b;
+    // Decimal-adjust the ones digit, then the tens digit.
+    if (((a & 0x0F) + (b & 0x0F)) > 0x09) { sum += 0x06; }
+    if (sum > 0x99) { sum += 0x60; }
+    if (carry) { *carry = (sum > 0xFF); }
+    return sum & 0xFF;
+}
+
+/*
+ * Compare two BCD words, like 0x00hhmmss time words.
+ * Packed BCD sorts the same way as plain binary, so this is just
+ * a normal unsigned compare: < 0, 0, > 0 like 'strcmp'.
+ */
+int bcd_cmp(unsigned int a, unsigned int b) {
+    if (a < b) { return -1; }
+    if (a > b) { return 1; }
+    return 0;
+}
+
+/*
+ * Add a number of minutes (BCD, 0-59) to a 0x0000hhmm BCD time,
+ * wrapping around midnight. Used for snooze times.
+ */
+unsigned int bcd_add_minutes(unsigned int hhmm, unsigned char mins_bcd) {
+    unsigned char carry;
+    unsigned char hours = (hhmm >> 8) & 0x3F;
+    unsigned char mins  = bcd_add(hhmm & 0x7F, mins_bcd, &carry);
+    // Minutes wrap at 60, not 100: subtract 60 by adding 40 (mod 100).
+    if (carry || mins >= BCD_WRAP_MINUTES) {
+        mins = bcd_add(mins, 0x40, 0);
+        hours = bcd_inc(hours, BCD_WRAP_HOURS);
+    }
+    return (hours << 8) | mins;
+}
+
+/*
+ * Convert a small binary value (0-99) to BCD by subtraction.
+ * This is for occasional conversions like temperatures; it still
+ * avoids pulling in '__aeabi_uidiv'.
+ */
+unsigned char bcd_from_bin(unsigned int v) {
+    unsigned char tens = 0;
+    while (v >= 10) {
+        v -= 10;
+        ++tens;
+    }
+    return (tens << 4) | v;
+}
@@ -0,0 +1,26 @@
+#ifndef _VVC_BCD_H
+#define _VVC_BCD_H
+
+// Packed BCD helpers. Values use the DS3231's register format,
+// 0bttttoooo, so that the time editors and the 7-segment output
+// never need a (software) division on Cortex-M0.
+
+// Wrap points for time fields.
+#define BCD_WRAP_HOURS    0x24
+#define BCD_WRAP_MINUTES  0x60
+
+// Digit extraction.
+#define BCD_TENS(v)       (((v) >> 4) & 0x0F)
+#define BCD_ONES(v)       ((v) & 0x0F)
+
+unsigned char bcd_inc(unsigned char v, unsigned char wrap);
+unsigned char bcd_dec(unsigned char v, unsigned char wrap);
+unsigned char bcd_inc_tens(unsigned char v, unsigned char wrap);
+unsigned char bcd_dec_tens(unsigned char v, unsigned char wrap);
+unsigned char bcd_add(unsigned char a, unsigned char b,
+                      unsigned char* carry);
+int bcd_cmp(unsigned int a, unsigned int b);
+unsigned int bcd_add_minutes(unsigned int hhmm, unsigned char mins_bcd);
+unsigned char bcd_from_bin(unsigned int v);
+
+#endif
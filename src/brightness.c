@@ -0,0 +1,51 @@
+#include "brightness.h"
+#include "seven_seg.h"
+
+// (RAM only; resets to the defaults on power-up.)
+static brightness_schedule_t brightness_sched;
+
+/*
+ * Load the default dimming schedule.
+ */
+void brightness_init(void) {
+    brightness_sched.day_level   = BRIGHTNESS_DEFAULT_DAY;
+    brightness_sched.night_level = BRIGHTNESS_DEFAULT_NIGHT;
+    brightness_sched.night_start = BRIGHTNESS_DEFAULT_NIGHT_START;
+    brightness_sched.night_end   = BRIGHTNESS_DEFAULT_NIGHT_END;
+}
+
+/*
+ * Get the schedule, for the menu to edit.
+ */
+brightness_schedule_t* brightness_schedule(void) {
+    return &brightness_sched;
+}
+
+/*
+ * Check whether an hour falls in the 'night' window. The window can
+ * wrap around midnight. (BCD hours compare like binary ones.)
+ */
+int brightness_is_night(unsigned char hrs_bcd) {
+    unsigned char start = brightness_sched.night_start;
+    unsigned char end = brightness_sched.night_end;
+    if (start == end) { return 0; }
+    if (start < end) {
+        return (hrs_bcd >= start && hrs_bcd < end);
+    }
+    return (hrs_bcd >= start || hrs_bcd < end);
+}
+
+/*
+ * Background task: follow the schedule. Only writes the brightness
+ * when the level changes, so this costs a compare on most frames.
+ * 'time' is a 0xddhhmmss BCD time word.
+ */
+void brightness_task(unsigned int time) {
+    unsigned char level = brightness_sched.day_level;
+    if (brightness_is_night((time & 0x003F0000) >> 16)) {
+        level = brightness_sched.night_level;
+    }
+    if (level != seven_seg_get_brightness()) {
+        seven_seg_set_brightness(level);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef _VVC_BRIGHTNESS_H
+#define _VVC_BRIGHTNESS_H
+
+#include "global.h"
+
+// Default time-of-day dimming schedule. (Hours are BCD.)
+#define BRIGHTNESS_DEFAULT_DAY          15
+#define BRIGHTNESS_DEFAULT_NIGHT        2
+#define BRIGHTNESS_DEFAULT_NIGHT_START  0x22
+#define BRIGHTNESS_DEFAULT_NIGHT_END    0x07
+
+// 7-segment brightness schedule: the 'night' level applies from
+// 'night_start' up to (not including) 'night_end', on the hour.
+typedef struct {
+    unsigned char day_level;
+    unsigned char night_level;
+    unsigned char night_start;
+    unsigned char night_end;
+} brightness_schedule_t;
+
+void brightness_init(void);
+brightness_schedule_t* brightness_schedule(void);
+int brightness_is_night(unsigned char hrs_bcd);
+void brightness_task(unsigned int time);
+
+#endif
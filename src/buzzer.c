@@ -0,0 +1,218 @@
+#include "buzzer.h"
+
+static void buzzer_sound(int on);
+static void buzzer_write_pulse(void);
+static void buzzer_set_freq(unsigned int freq_hz);
+static void buzzer_set_pulse(void);
+
+// Duty cycle for each volume step, x/256 of the tone period. A
+// piezo's loudness follows the duty cycle roughly logarithmically,
+// so the steps are spaced evenly on a log scale up to a square wave.
+static const unsigned char buzzer_volume_duty[BUZZER_VOLUME_STEPS] = {
+    1, 2, 3, 4, 6, 8, 11, 15, 20, 27, 36, 48, 64, 82, 104,
+    BUZZER_DUTY_LOUDEST
+};
+
+static volatile buzzer_t buzzer;
+
+#ifdef STM32F031
+/*
+ * Start TIM2 as a PWM output on PA3, silent for now.
+ * Period and compare are both preloaded, so retuning never glitches
+ * the wave in the middle of a cycle.
+ */
+void buzzer_init(void) {
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+    GPIO_PinAFConfig(GPIOA, IOA_BUZZER_PINSRC, GPIO_AF_2);
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOA_BUZZER_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_AF;
+    gpio_init_struct.GPIO_OType = GPIO_OType_PP;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_2MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+    BUZZER_TIM->CR1   = 0;
+    BUZZER_TIM->PSC   = BUZZER_PRESCALER;
+    BUZZER_TIM->ARR   = (BUZZER_TIMER_HZ / BUZZER_ALARM_HZ) - 1;
+    BUZZER_TIM->CCR4  = 0;
+    // PWM mode 1: high while CNT < CCR4.
+    BUZZER_TIM->CCMR2 = TIM_CCMR2_OC4M_2 | TIM_CCMR2_OC4M_1 |
+                        TIM_CCMR2_OC4PE;
+    BUZZER_TIM->CCER  = TIM_CCER_CC4E;
+    BUZZER_TIM->EGR   = TIM_EGR_UG;
+    BUZZER_TIM->CR1   = TIM_CR1_ARPE | TIM_CR1_CEN;
+    buzzer.sounding = 0;
+    buzzer_ramp(0);
+    buzzer_set_freq(BUZZER_ALARM_HZ);
+}
+
+/*
+ * Gate the tone. (A zero compare value holds the pin low.)
+ */
+static void buzzer_sound(int on) {
+    buzzer.sounding = on;
+    BUZZER_TIM->ARR  = buzzer.period - 1;
+    BUZZER_TIM->CCR4 = on ? buzzer.pulse : 0;
+}
+
+/*
+ * Apply a new pulse width to the tone that is playing.
+ * (Preloaded, so it takes effect at the next cycle.)
+ */
+static void buzzer_write_pulse(void) {
+    if (buzzer.sounding) { BUZZER_TIM->CCR4 = buzzer.pulse; }
+}
+#else
+/*
+ * Start TIM17's interrupts for software PWM on PA3. The pin is
+ * already a GPIO output; the timer only runs while the tone sounds.
+ */
+void buzzer_init(void) {
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM17, ENABLE);
+    GPIOA->BRR = IOA_BUZZER_PIN;
+    BUZZER_TIM->CR1  = 0;
+    BUZZER_TIM->PSC  = BUZZER_PRESCALER;
+    BUZZER_TIM->ARR  = (BUZZER_TIMER_HZ / BUZZER_ALARM_HZ) - 1;
+    BUZZER_TIM->CCR1 = 0;
+    BUZZER_TIM->EGR  = TIM_EGR_UG;
+    BUZZER_TIM->SR   = 0;
+    BUZZER_TIM->DIER = TIM_DIER_UIE | TIM_DIER_CC1IE;
+    NVIC_EnableIRQ(BUZZER_IRQn);
+    buzzer.sounding = 0;
+    buzzer_ramp(0);
+    buzzer_set_freq(BUZZER_ALARM_HZ);
+}
+
+/*
+ * Gate the tone by starting or stopping the timer. It restarts from
+ * the top of a cycle, and the pin is left low when it stops.
+ */
+static void buzzer_sound(int on) {
+    buzzer.sounding = on;
+    BUZZER_TIM->CR1 = 0;
+    GPIOA->BRR = IOA_BUZZER_PIN;
+    if (on) {
+        BUZZER_TIM->ARR  = buzzer.period - 1;
+        BUZZER_TIM->CCR1 = buzzer.pulse;
+        BUZZER_TIM->CNT  = 0;
+        BUZZER_TIM->CR1  = TIM_CR1_CEN;
+    }
+}
+
+/*
+ * Apply a new pulse width to the tone that is playing.
+ */
+static void buzzer_write_pulse(void) {
+    BUZZER_TIM->CCR1 = buzzer.pulse;
+}
+
+/*
+ * TIM17 interrupt: pin high at the start of each cycle, low at the
+ * compare. (Two short interrupts per cycle; ~10K/s at 5KHz.)
+ */
+void TIM17_IRQ_handler(void) {
+    unsigned int sr = BUZZER_TIM->SR;
+    BUZZER_TIM->SR = ~sr;
+    if (sr & TIM_SR_UIF) {
+        GPIOA->BSRR = IOA_BUZZER_PIN;
+    }
+    if (sr & TIM_SR_CC1IF) {
+        GPIOA->BRR = IOA_BUZZER_PIN;
+    }
+}
+#endif
+
+/*
+ * Work out the timer period for a tone, at a square wave.
+ */
+static void buzzer_set_freq(unsigned int freq_hz) {
+    if (freq_hz < BUZZER_MIN_HZ) { freq_hz = BUZZER_MIN_HZ; }
+    buzzer.period = BUZZER_PERIOD(freq_hz);
+    buzzer_set_pulse();
+}
+
+/*
+ * Work out the pulse width for the current period and volume.
+ * (Never 0, or the quietest steps would be silent on short periods.)
+ */
+static void buzzer_set_pulse(void) {
+    buzzer.pulse = (buzzer.period * buzzer_volume_duty[buzzer.volume]) >> 8;
+    if (!buzzer.pulse) { buzzer.pulse = 1; }
+}
+
+/*
+ * Sound a tone with a given timer period, or go quiet if it is 0.
+ * This skips the frequency math, so it is cheap enough for the tone
+ * sequencer to call from its interrupt.
+ */
+void buzzer_set_period(unsigned int period) {
+    if (period) {
+        buzzer.period = period;
+        buzzer_set_pulse();
+    }
+    buzzer_sound(period != 0);
+}
+
+void buzzer_stop(void) {
+    buzzer_sound(0);
+}
+
+/*
+ * Check whether a tone is sounding right now.
+ */
+int buzzer_active(void) {
+    return buzzer.sounding;
+}
+
+/*
+ * Set the volume, from 0 (barely audible) to BUZZER_VOLUME_STEPS-1.
+ * This also cancels any crescendo.
+ */
+void buzzer_set_volume(unsigned char step) {
+    if (step >= BUZZER_VOLUME_STEPS) { step = BUZZER_VOLUME_STEPS - 1; }
+    buzzer.ramp_step_ms = 0;
+    buzzer.volume = step;
+    buzzer_set_pulse();
+    buzzer_write_pulse();
+}
+
+/*
+ * Crescendo: start at the quietest volume, and step up through the
+ * volume table to the loudest over 'ramp_ms'. 0 means loudest now.
+ * The ramp runs on whatever is playing, and the volume stays at the
+ * loudest afterwards.
+ */
+void buzzer_ramp(unsigned int ramp_ms) {
+    if (!ramp_ms) {
+        buzzer_set_volume(BUZZER_VOLUME_STEPS - 1);
+        return;
+    }
+    buzzer_set_volume(0);
+    buzzer.ramp_ms = 0;
+    buzzer.ramp_step_ms = ramp_ms / (BUZZER_VOLUME_STEPS - 1);
+    if (!buzzer.ramp_step_ms) { buzzer.ramp_step_ms = 1; }
+}
+
+/*
+ * Get the current volume as an amplitude scale, x/256.
+ * (For sample playback; see audio.h)
+ */
+unsigned int buzzer_volume_scale(void) {
+    return buzzer_volume_duty[buzzer.volume] * 2;
+}
+
+/*
+ * Step the crescendo. Called from the 1KHz tick.
+ */
+void buzzer_tick(void) {
+    if (buzzer.ramp_step_ms && ++buzzer.ramp_ms >= buzzer.ramp_step_ms) {
+        buzzer.ramp_ms = 0;
+        ++buzzer.volume;
+        if (buzzer.volume >= BUZZER_VOLUME_STEPS - 1) {
+            buzzer.volume = BUZZER_VOLUME_STEPS - 1;
+            buzzer.ramp_step_ms = 0;
+        }
+        buzzer_set_pulse();
+        buzzer_write_pulse();
+    }
+}
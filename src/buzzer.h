@@ -0,0 +1,56 @@
+#ifndef _VVC_BUZZER_H
+#define _VVC_BUZZER_H
+
+#include "global.h"
+
+// Non-blocking buzzer on PA3. A timer makes the tone; the tone
+// sequencer picks the notes, and the 1KHz tick steps the crescendo.
+// (See tone.h and tick.h) None of these calls wait for anything.
+#ifdef STM32F031
+// TIM2 channel 4 drives PA3 as a PWM output. (AF2)
+#define BUZZER_TIM              TIM2
+#else
+// The F030F4 has no timer channel on PA3, so TIM17's update and
+// compare interrupts set and clear the pin instead.
+#define BUZZER_TIM              TIM17
+#define BUZZER_IRQn             TIM17_IRQn
+#endif
+// 48MHz / (7+1) = 6MHz timer clock. The lowest tone that fits in a
+// 16-bit period is ~92Hz.
+#define BUZZER_PRESCALER        7
+#define BUZZER_TIMER_HZ         6000000
+#define BUZZER_MIN_HZ           92
+// Timer period for a tone. (Usable in const tables.)
+#define BUZZER_PERIOD(hz)       (BUZZER_TIMER_HZ / (hz))
+// Duty cycle, x/256 of the tone period. A square wave (50%) is the
+// loudest that a piezo buzzer gets; shorter pulses are quieter.
+#define BUZZER_DUTY_LOUDEST     128
+#define BUZZER_VOLUME_STEPS     16
+
+// Tone that the timer is set up with, until the first note.
+#define BUZZER_ALARM_HZ         2500
+
+typedef struct {
+    // Tone period and 'on' time, in timer ticks.
+    unsigned int   period;
+    unsigned int   pulse;
+    unsigned char  sounding;
+    // Volume step, and crescendo progress. (No step time = no ramp.)
+    unsigned char  volume;
+    unsigned short ramp_ms;
+    unsigned short ramp_step_ms;
+} buzzer_t;
+
+void buzzer_init(void);
+void buzzer_stop(void);
+void buzzer_set_period(unsigned int period);
+void buzzer_set_volume(unsigned char step);
+void buzzer_ramp(unsigned int ramp_ms);
+unsigned int buzzer_volume_scale(void);
+int buzzer_active(void);
+void buzzer_tick(void);
+#ifndef STM32F031
+void TIM17_IRQ_handler(void);
+#endif
+
+#endif
@@ -0,0 +1,234 @@
+#include "console.h"
+#include "rtc_calib.h"
+#include "rtc_stats.h"
+#include "ds3231_cache.h"
+#include "timebase.h"
+#include "sched.h"
+#include "util_c.h"
+
+#ifdef VVC_SERIAL_CONSOLE
+// Receive line buffer; filled by the USART interrupt.
+static volatile char console_line[CONSOLE_LINE_LEN];
+static volatile unsigned char console_line_len;
+static volatile unsigned char console_line_ready;
+// Timebase value when the line's terminator arrived.
+static volatile unsigned int console_line_stamp_us;
+
+/*
+ * Set up USART1 in single-wire half-duplex mode, 115200-8-N-1.
+ */
+void console_init(void) {
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1, ENABLE);
+    // Half-duplex mode needs an open-drain TX pin with a pullup.
+    GPIO_PinAFConfig(GPIOA, IOA_CONSOLE_PINSRC, GPIO_AF_1);
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOA_CONSOLE_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_AF;
+    gpio_init_struct.GPIO_OType = GPIO_OType_OD;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_2MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_UP;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+
+    console_line_len = 0;
+    console_line_ready = 0;
+    USART1->CR1 = 0;
+    USART1->BRR = CONSOLE_BRR;
+    USART1->CR3 = USART_CR3_HDSEL;
+    USART1->CR1 = USART_CR1_TE | USART_CR1_RE | USART_CR1_RXNEIE;
+    USART1->CR1 |= USART_CR1_UE;
+    NVIC_EnableIRQ(USART1_IRQn);
+}
+
+/*
+ * Send a string, blocking until it has gone out. The receiver is
+ * turned off meanwhile, so we don't read back our own echo.
+ */
+void console_write(char* str) {
+    USART1->CR1 &= ~USART_CR1_RE;
+    while (*str) {
+        while (!(USART1->ISR & USART_ISR_TXE)) {}
+        USART1->TDR = *str++;
+    }
+    while (!(USART1->ISR & USART_ISR_TC)) {}
+    USART1->CR1 |= USART_CR1_RE;
+}
+
+/*
+ * Send a signed decimal integer.
+ */
+void console_write_int(int val) {
+    char buf[12];
+    fmt_int(buf, val, 1);
+    console_write(buf);
+}
+
+/*
+ * Parse an unsigned decimal argument, skipping leading spaces.
+ */
+static unsigned int console_parse_uint(volatile char* str) {
+    unsigned int val = 0;
+    while (*str == ' ') { ++str; }
+    while (*str >= '0' && *str <= '9') {
+        val = (val * 10) + (*str - '0');
+        ++str;
+    }
+    return val;
+}
+
+/*
+ * Report the calibration state.
+ */
+static void console_report_calib(void) {
+    rtc_calib_t* calib = rtc_calib_status();
+    if (!calib->active) {
+        console_write("cal idle\r\n");
+    }
+    else if (!calib->have_estimate) {
+        console_write("cal started\r\n");
+    }
+    else {
+        console_write("cal s:");
+        console_write_int(calib->elapsed_s);
+        console_write(" ppb:");
+        console_write_int(calib->drift_ppb);
+        console_write(" adj:");
+        console_write_int(calib->suggested_delta);
+        console_write("\r\n");
+    }
+}
+
+/*
+ * Dump the drift/uptime statistics on one line.
+ */
+static void console_report_stats(void) {
+    char buf[12];
+    rtc_stats_t stats;
+    rtc_stats_summary_t summary;
+    rtc_stats_snapshot(&stats);
+    rtc_stats_summary(&stats, &summary);
+    console_write("up:");
+    console_write_int(stats.uptime_s);
+    console_write(rtc_stats_sqw_ok() ? " n:" : " nosqw n:");
+    console_write_int(summary.samples);
+    console_write(" ppb:");
+    console_write_int(summary.mean_ppb);
+    console_write(" var:");
+    fmt_q8(buf, summary.var_q8);
+    console_write(buf);
+    console_write(" min:");
+    console_write_int(summary.min_dev);
+    console_write(" max:");
+    console_write_int(summary.max_dev);
+    console_write(" lost:");
+    console_write_int(stats.outliers);
+    console_write(" rs:");
+    console_write_int(stats.resyncs);
+    console_write(" last:");
+    console_write_int(stats.last_resync_s);
+    console_write("@");
+    console_write_int(stats.last_resync_uptime_s);
+    console_write("\r\n");
+}
+
+/*
+ * Dump each scheduler task's statistics, one line per task, in the
+ * order that they were added. (See main.c)
+ */
+static void console_report_tasks(void) {
+    int i;
+    for (i = 0; i < sched_count(); ++i) {
+        sched_task_t* t = sched_task(i);
+        console_write("task");
+        console_write_int(i);
+        console_write(" runs:");
+        console_write_int(t->runs);
+        console_write(" late:");
+        console_write_int(t->late);
+        console_write(" us:");
+        console_write_int(t->last_us);
+        console_write(" max:");
+        console_write_int(t->max_us);
+        console_write("\r\n");
+    }
+}
+
+/*
+ * Run one received command line, if there is one. Commands:
+ *   R <n>: Reference time; 'n' is a whole-second count, sent right as
+ *          that second starts. Starts or updates a calibration.
+ *   A:     Apply the suggested aging-offset correction.
+ *   X:     Abandon the calibration.
+ *   T:     Print the temperature and current aging offset.
+ *   S:     Dump the drift/uptime statistics.
+ *   K:     Dump the main loop tasks' run counts, late starts, and
+ *          last/worst run times.
+ */
+void console_poll(void) {
+    if (!console_line_ready) { return; }
+    char cmd = console_line[0];
+    if (cmd == 'R' || cmd == 'r') {
+        unsigned int ref_s = console_parse_uint(&console_line[1]);
+        if (rtc_calib_reference(ref_s, console_line_stamp_us)) {
+            console_report_calib();
+        }
+        else {
+            console_write("no rtc edge\r\n");
+        }
+    }
+    else if (cmd == 'A' || cmd == 'a') {
+        console_write("aging:");
+        console_write_int(rtc_calib_apply());
+        console_write("\r\n");
+    }
+    else if (cmd == 'X' || cmd == 'x') {
+        rtc_calib_stop();
+        console_report_calib();
+    }
+    else if (cmd == 'T' || cmd == 't') {
+        char temp_buffer[10];
+        rtc_format_temperature(temp_buffer);
+        console_write("temp:");
+        console_write(temp_buffer);
+        console_write(" aging:");
+        console_write_int(ds3231_cache_get_aging());
+        console_write("\r\n");
+    }
+    else if (cmd == 'S' || cmd == 's') {
+        console_report_stats();
+    }
+    else if (cmd == 'K' || cmd == 'k') {
+        console_report_tasks();
+    }
+    else {
+        console_write("?\r\n");
+    }
+    console_line_len = 0;
+    console_line_ready = 0;
+}
+
+/*
+ * USART1 interrupt: collect received characters into a line.
+ * The terminator is timestamped here, since the main loop might not
+ * get to the line for a whole frame.
+ */
+void USART1_IRQ_handler(void) {
+    if (USART1->ISR & USART_ISR_ORE) {
+        USART1->ICR = USART_ICR_ORECF;
+    }
+    if (USART1->ISR & USART_ISR_RXNE) {
+        char c = USART1->RDR;
+        // (Drop input until the last line has been handled.)
+        if (console_line_ready) { return; }
+        if (c == '\r' || c == '\n') {
+            if (console_line_len) {
+                console_line_stamp_us = timebase_us();
+                console_line[console_line_len] = '\0';
+                console_line_ready = 1;
+            }
+        }
+        else if (console_line_len < (CONSOLE_LINE_LEN - 1)) {
+            console_line[console_line_len++] = c;
+        }
+    }
+}
+#endif
@@ -0,0 +1,24 @@
+#ifndef _VVC_CONSOLE_H
+#define _VVC_CONSOLE_H
+
+#include "global.h"
+
+#ifdef VVC_SERIAL_CONSOLE
+// Line-based serial console on USART1, for calibration/diagnostics.
+// It runs in single-wire half-duplex mode on PA14, because the
+// TSSOP-20 packages have no other free USART pins. (That pin is SWCLK,
+// so debugging over SWD is not possible in console builds.)
+#define IOA_CONSOLE_PIN      GPIO_Pin_14
+#define IOA_CONSOLE_PINSRC   GPIO_PinSource14
+// 115200 baud from the 48MHz PCLK.
+#define CONSOLE_BRR          417
+#define CONSOLE_LINE_LEN     24
+
+void console_init(void);
+void console_write(char* str);
+void console_write_int(int val);
+void console_poll(void);
+void USART1_IRQ_handler(void);
+#endif
+
+#endif
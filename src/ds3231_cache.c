@@ -0,0 +1,215 @@
+#include "ds3231_cache.h"
+
+// RAM mirror of the DS3231's 0x00-0x12 register map.
+static volatile ds3231_cache_t ds3231_cache;
+
+/*
+ * Fill the whole mirror with a single burst read.
+ * This replaces the separate reads which boot used to make.
+ */
+void ds3231_cache_init(void) {
+    ds3231_cache.dirty = 0;
+    ds3231_cache_refresh(0, DS3231_NUM_REGS);
+}
+
+/*
+ * Mark registers as stale, so that the next read of them goes to the
+ * bus. Only call this after an event which can change the hardware
+ * state behind our back, like a power loss or an oscillator stop.
+ * Pending writes to those registers are dropped.
+ */
+void ds3231_cache_invalidate(unsigned int reg_mask) {
+    ds3231_cache.valid &= ~reg_mask;
+    ds3231_cache.dirty &= ~reg_mask;
+}
+
+/*
+ * Re-read a contiguous block of registers into the mirror.
+ */
+void ds3231_cache_refresh(unsigned char first_reg, unsigned char count) {
+    ds3231_read_registers(I2C1_BASE, first_reg,
+                          &ds3231_cache.regs[first_reg], count);
+    unsigned int mask = ((0x00000001 << count) - 1) << first_reg;
+    ds3231_cache.valid |= mask;
+    ds3231_cache.dirty &= ~mask;
+}
+
+/*
+ * Get a register value. Valid registers are served from RAM
+ * without touching the bus.
+ */
+unsigned char ds3231_cache_get(unsigned char reg) {
+    if (!(ds3231_cache.valid & DS3231_REG_BIT(reg))) {
+        ds3231_cache_refresh(reg, 1);
+    }
+    return ds3231_cache.regs[reg];
+}
+
+/*
+ * Set a register value in the mirror, and mark it dirty.
+ * The bus write happens in 'ds3231_cache_commit'.
+ */
+void ds3231_cache_set(unsigned char reg, unsigned char val) {
+    ds3231_cache.regs[reg] = val;
+    ds3231_cache.valid |= DS3231_REG_BIT(reg);
+    ds3231_cache.dirty |= DS3231_REG_BIT(reg);
+}
+
+/*
+ * Write every dirty register back to the DS3231. Runs of adjacent
+ * dirty registers are sent as one burst write each.
+ */
+void ds3231_cache_commit(void) {
+    unsigned char reg = 0;
+    while (ds3231_cache.dirty && reg < DS3231_NUM_REGS) {
+        if (!(ds3231_cache.dirty & DS3231_REG_BIT(reg))) {
+            ++reg;
+            continue;
+        }
+        unsigned char run_start = reg;
+        while (reg < DS3231_NUM_REGS &&
+               (ds3231_cache.dirty & DS3231_REG_BIT(reg))) {
+            ds3231_cache.dirty &= ~DS3231_REG_BIT(reg);
+            ++reg;
+        }
+        ds3231_write_registers(I2C1_BASE, run_start,
+                               &ds3231_cache.regs[run_start],
+                               reg - run_start);
+    }
+}
+
+/*
+ * Re-read the current time from the DS3231.
+ * Returns the same word as 'ds3231_get_time': 0xddhhmmss, BCD.
+ */
+unsigned int ds3231_cache_sync_time(void) {
+    ds3231_cache_refresh(DS3231_REG_SECONDS, 4);
+    return (ds3231_cache.regs[DS3231_REG_DAY] << 24) |
+           (ds3231_cache.regs[DS3231_REG_HOURS] << 16) |
+           (ds3231_cache.regs[DS3231_REG_MINUTES] << 8) |
+           ds3231_cache.regs[DS3231_REG_SECONDS];
+}
+
+/*
+ * Set the current hours/minutes (write-through). Seconds are reset
+ * to 0, which also restarts the DS3231's countdown chain so that
+ * the new time starts on a whole second.
+ */
+void ds3231_cache_set_time(unsigned char hrs_bcd, unsigned char mins_bcd) {
+    ds3231_cache_set(DS3231_REG_SECONDS, 0x00);
+    ds3231_cache_set(DS3231_REG_MINUTES, mins_bcd);
+    ds3231_cache_set(DS3231_REG_HOURS, hrs_bcd);
+    ds3231_cache_commit();
+}
+
+/*
+ * Get the 'alarm 1' minutes/hours, in the same format as
+ * 'ds3231_get_alarm_1': 0x0000hhmm.
+ */
+unsigned int ds3231_cache_get_alarm_1(void) {
+    return (ds3231_cache_get(DS3231_REG_A1_HOURS) << 8) |
+           ds3231_cache_get(DS3231_REG_A1_MINUTES);
+}
+
+/*
+ * Set the 'alarm 1' minutes/hours (write-through).
+ */
+void ds3231_cache_set_alarm_1_time(unsigned char hrs_bcd,
+                                   unsigned char mins_bcd) {
+    ds3231_cache_set(DS3231_REG_A1_MINUTES, mins_bcd);
+    ds3231_cache_set(DS3231_REG_A1_HOURS, hrs_bcd);
+    ds3231_cache_commit();
+}
+
+/*
+ * Set 'alarm 2' to go off when the hours and minutes match, and clear
+ * its flag (write-through). The alarm registers go out in one burst;
+ * the status register in a second one, like 'ds3231_cache_clear_osf'.
+ */
+void ds3231_cache_set_alarm_2_time(unsigned char hrs_bcd,
+                                   unsigned char mins_bcd) {
+    ds3231_cache_set(DS3231_REG_A2_MINUTES, mins_bcd);
+    ds3231_cache_set(DS3231_REG_A2_HOURS, hrs_bcd);
+    ds3231_cache_set(DS3231_REG_A2_DAY, DS3231_ALARM_MASK);
+    unsigned char status = ds3231_cache_get(DS3231_REG_STATUS);
+    status |= DS3231_STATUS_A1F;
+    status &= ~DS3231_STATUS_A2F;
+    ds3231_cache_set(DS3231_REG_STATUS, status);
+    ds3231_cache_commit();
+    ds3231_cache_invalidate(DS3231_REG_BIT(DS3231_REG_STATUS));
+}
+
+/*
+ * Re-read the status register, and check the 'alarm 2' flag.
+ * The flag latches until 'ds3231_cache_set_alarm_2_time' clears it,
+ * so it can be checked at any point after the match.
+ */
+int ds3231_cache_alarm_2_fired(void) {
+    ds3231_cache_refresh(DS3231_REG_STATUS, 1);
+    return (ds3231_cache.regs[DS3231_REG_STATUS] & DS3231_STATUS_A2F) != 0;
+}
+
+/*
+ * Check the 'oscillator stopped' flag, from the last status read.
+ * If it is set, the DS3231 lost power at some point and its time and
+ * alarm registers can't be trusted.
+ */
+int ds3231_cache_osc_stopped(void) {
+    return (ds3231_cache_get(DS3231_REG_STATUS) & DS3231_STATUS_OSF) != 0;
+}
+
+/*
+ * Clear the 'oscillator stopped' flag (write-through).
+ * The alarm flags can only be written to 0, so writing 1s to them
+ * leaves them alone. Since they might have changed in the meantime,
+ * the status register's mirror is invalidated afterwards.
+ */
+void ds3231_cache_clear_osf(void) {
+    unsigned char status = ds3231_cache_get(DS3231_REG_STATUS);
+    status |= (DS3231_STATUS_A2F | DS3231_STATUS_A1F);
+    status &= ~DS3231_STATUS_OSF;
+    ds3231_cache_set(DS3231_REG_STATUS, status);
+    ds3231_cache_commit();
+    ds3231_cache_invalidate(DS3231_REG_BIT(DS3231_REG_STATUS));
+}
+
+/*
+ * Re-read the temperature registers. The DS3231 only converts every
+ * 64 seconds, so there is no point in calling this more often.
+ * Returns the temperature in units of 0.25C.
+ */
+int ds3231_cache_sync_temperature(void) {
+    ds3231_cache_refresh(DS3231_REG_TEMP_MSB, 2);
+    return ds3231_cache_get_temperature();
+}
+
+/*
+ * Get the last temperature reading from the mirror, in units of 0.25C.
+ * (MSB is a signed integer, LSB holds the fraction in bits [7:6].)
+ */
+int ds3231_cache_get_temperature(void) {
+    signed char whole = ds3231_cache_get(DS3231_REG_TEMP_MSB);
+    return (whole * 4) | (ds3231_cache_get(DS3231_REG_TEMP_LSB) >> 6);
+}
+
+/*
+ * Get the signed aging offset trim. (~0.1ppm per LSB at 25C)
+ */
+int ds3231_cache_get_aging(void) {
+    return (signed char)ds3231_cache_get(DS3231_REG_AGING);
+}
+
+/*
+ * Set the aging offset trim (write-through), and force a temperature
+ * conversion so that the new value is applied to the oscillator now
+ * instead of at the next 64-second conversion.
+ */
+void ds3231_cache_set_aging(int aging) {
+    ds3231_cache_set(DS3231_REG_AGING, (unsigned char)aging);
+    ds3231_cache_set(DS3231_REG_CONTROL,
+                     ds3231_cache_get(DS3231_REG_CONTROL) |
+                     DS3231_CONTROL_CONV);
+    ds3231_cache_commit();
+    // CONV clears itself once the conversion finishes.
+    ds3231_cache.regs[DS3231_REG_CONTROL] &= ~DS3231_CONTROL_CONV;
+}
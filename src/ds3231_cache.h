@@ -0,0 +1,83 @@
+#ifndef _VVC_DS3231_CACHE_H
+#define _VVC_DS3231_CACHE_H
+
+#include "global.h"
+
+// DS3231 register map.
+#define DS3231_REG_SECONDS      0x00
+#define DS3231_REG_MINUTES      0x01
+#define DS3231_REG_HOURS        0x02
+#define DS3231_REG_DAY          0x03
+#define DS3231_REG_DATE         0x04
+#define DS3231_REG_MONTH        0x05
+#define DS3231_REG_YEAR         0x06
+#define DS3231_REG_A1_SECONDS   0x07
+#define DS3231_REG_A1_MINUTES   0x08
+#define DS3231_REG_A1_HOURS     0x09
+#define DS3231_REG_A1_DAY       0x0A
+#define DS3231_REG_A2_MINUTES   0x0B
+#define DS3231_REG_A2_HOURS     0x0C
+#define DS3231_REG_A2_DAY       0x0D
+#define DS3231_REG_CONTROL      0x0E
+#define DS3231_REG_STATUS       0x0F
+#define DS3231_REG_AGING        0x10
+#define DS3231_REG_TEMP_MSB     0x11
+#define DS3231_REG_TEMP_LSB     0x12
+#define DS3231_NUM_REGS         0x13
+
+// Register bitmasks for the valid/dirty/invalidate masks.
+#define DS3231_REG_BIT(reg)     (0x00000001 << (reg))
+#define DS3231_ALL_REGS         ((0x00000001 << DS3231_NUM_REGS) - 1)
+// Registers which the DS3231 changes on its own. Their mirror is only
+// as fresh as the last sync, and nothing else invalidates them.
+#define DS3231_TIME_REGS        0x0000007F
+#define DS3231_LIVE_REGS        (DS3231_TIME_REGS | \
+                                 DS3231_REG_BIT(DS3231_REG_STATUS) | \
+                                 DS3231_REG_BIT(DS3231_REG_TEMP_MSB) | \
+                                 DS3231_REG_BIT(DS3231_REG_TEMP_LSB))
+
+// Control register bits.
+#define DS3231_CONTROL_CONV     0x20
+#define DS3231_CONTROL_RS_MASK  0x18
+#define DS3231_CONTROL_INTCN    0x04
+
+// Alarm register mask bit. (Set = 'don't compare this field')
+#define DS3231_ALARM_MASK       0x80
+
+// Status register flags.
+#define DS3231_STATUS_OSF       0x80
+#define DS3231_STATUS_A2F       0x02
+#define DS3231_STATUS_A1F       0x01
+
+// RAM mirror of the register map, with per-register valid/dirty bits.
+typedef struct {
+    unsigned char regs[DS3231_NUM_REGS];
+    unsigned int  valid;
+    unsigned int  dirty;
+} ds3231_cache_t;
+
+// Mirror management.
+void ds3231_cache_init(void);
+void ds3231_cache_invalidate(unsigned int reg_mask);
+void ds3231_cache_refresh(unsigned char first_reg, unsigned char count);
+unsigned char ds3231_cache_get(unsigned char reg);
+void ds3231_cache_set(unsigned char reg, unsigned char val);
+void ds3231_cache_commit(void);
+
+// Field accessors.
+unsigned int ds3231_cache_sync_time(void);
+void ds3231_cache_set_time(unsigned char hrs_bcd, unsigned char mins_bcd);
+unsigned int ds3231_cache_get_alarm_1(void);
+void ds3231_cache_set_alarm_1_time(unsigned char hrs_bcd,
+                                   unsigned char mins_bcd);
+void ds3231_cache_set_alarm_2_time(unsigned char hrs_bcd,
+                                   unsigned char mins_bcd);
+int ds3231_cache_alarm_2_fired(void);
+int ds3231_cache_osc_stopped(void);
+void ds3231_cache_clear_osf(void);
+int ds3231_cache_sync_temperature(void);
+int ds3231_cache_get_temperature(void);
+int ds3231_cache_get_aging(void);
+void ds3231_cache_set_aging(int aging);
+
+#endif
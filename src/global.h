@@ -20,36 +20,79 @@
 #define VVC_STATE_SET_ALARM_DAYS   0x06
 #define VVC_STATE_SET_ALARM_TONE   0x07
 #define VVC_STATE_SET_ALARM_STATE  0x08
+#define VVC_STATE_MENU_PAGE_3      0x09
+#define VVC_STATE_DIAGNOSTICS      0x0A
+#define VVC_STATE_SET_BRIGHTNESS   0x0B
+#define VVC_STATE_LATENCY          0x0C
+#define VVC_STATE_POWER            0x0D
+
+// 'alarm_word' value which never matches a time.
+#define VVC_ALARM_UNSET            0xFFFFFFFF
 
 // 128x64-px monochrome. (1 Byte = 8 pixels)
 // TODO: support 128x32-px version of the screen.
 #define OLED_FB_SIZE (128*64)/8
 
 // Pin definitions. (GPIOA)
+#ifdef VVC_SEVEN_SEG_SPI
+// (SPI1 drives the 74HC595s: SCK = PA5, MOSI = PA7.
+//  The Up/Down buttons move to the pins that frees up.)
+#define IOA_595_CLOCK_PIN    GPIO_Pin_5
+#define IOA_595_CLOCK_PINSRC GPIO_PinSource5
+#define IOA_595_DATA_PIN     GPIO_Pin_7
+#define IOA_595_DATA_PINSRC  GPIO_PinSource7
+#else
 #define IOA_595_CLOCK_PIN GPIO_Pin_0
 #define IOA_595_DATA_PIN  GPIO_Pin_1
+#endif
 #define IOA_595_LATCH_PIN GPIO_Pin_2
 #define IOA_BUZZER_PIN    GPIO_Pin_3
+#define IOA_BUZZER_PINSRC GPIO_PinSource3
+// (DS3231 SQW/INT output, captured by TIM14 channel 1.)
+#define IOA_RTC_SQW_PIN    GPIO_Pin_4
+#define IOA_RTC_SQW_PINSRC GPIO_PinSource4
+// (With an ADC button ladder, these only name the buttons; the ladder
+//  is on the Select pin, and the other two are free. See input.h)
+#define IOA_LADDER_PIN    GPIO_Pin_6
+// (With touch pads, the sampling capacitors' shared pin. That is
+//  SWCLK, like the serial console's pin; see input.h)
+#define IOA_TOUCH_SAMPLE_PIN GPIO_Pin_14
+#ifdef VVC_SEVEN_SEG_SPI
+#define IOA_BUTTON_UP     GPIO_Pin_0
+#define IOA_BUTTON_SELECT GPIO_Pin_6
+#define IOA_BUTTON_DOWN   GPIO_Pin_1
+#else
 #define IOA_BUTTON_UP     GPIO_Pin_5
 #define IOA_BUTTON_SELECT GPIO_Pin_6
 #define IOA_BUTTON_DOWN   GPIO_Pin_7
+#endif
+// Pin definitions. (GPIOB)
+// (74HC595 output-enable, active-low; PWM'd by TIM3 channel 4.)
+#define IOB_595_OE_PIN    GPIO_Pin_1
+#define IOB_595_OE_PINSRC GPIO_PinSource1
+#ifdef VVC_SEVEN_SEG_DIRECT
+// Direct-drive displays: bit N of a digit's segment byte is PB(N),
+// sinking through a resistor. The digits' common anodes are switched
+// by PNP transistors on PA8/PA11/PA12/PA15. Both are active-low.
+// (These pins only exist on the larger packages.)
+#define IOB_SEG_PINS      0x00FF
+#define IOA_DIGIT_0_PIN   GPIO_Pin_8
+#define IOA_DIGIT_1_PIN   GPIO_Pin_11
+#define IOA_DIGIT_2_PIN   GPIO_Pin_12
+#define IOA_DIGIT_3_PIN   GPIO_Pin_15
+#define IOA_DIGIT_PINS    (IOA_DIGIT_0_PIN | IOA_DIGIT_1_PIN | \
+                           IOA_DIGIT_2_PIN | IOA_DIGIT_3_PIN)
+#endif
 
 // Assembly methods.
 // Delay a given # of microseconds (+/- like 5-10% I guess, see src/util.S)
 extern void delay_us(unsigned int d);
 // Shift register output methods.
-extern void shift_byte_out(unsigned char dat,
-                           volatile void* gpiox_odr,
+extern void shift_word_out(unsigned int dat,
+                           volatile void* gpiox,
                            unsigned int clock_pinmask,
-                           unsigned int data_pinmask);
-extern void shift_7_segment_out(int num,
-                                volatile void* gpiox_odr,
-                                unsigned int clock_pinmask,
-                                unsigned int data_pinmask);
-extern void pulse_out_pin(volatile void* gpiox_odr,
-                          unsigned int pulse_pinmask,
-                          unsigned int pulse_halfw,
-                          unsigned int num_pulses);
+                           unsigned int data_pinmask,
+                           unsigned int latch_pinmask);
 // I2C peripheral and device commands.
 extern void i2c_periph_init(unsigned int i2c_addr, unsigned int i2c_speed);
 extern unsigned char i2c_read_register(unsigned int i2c_register,
@@ -63,17 +106,32 @@ extern unsigned int ds3231_get_time(unsigned int i2c_addr);
 extern void ds3231_set_time(unsigned int i2c_addr, int hrs_btc, int mins_btc);
 extern unsigned int ds3231_get_alarm_1(unsigned int i2c_addr);
 extern void ds3231_set_alarm_1_time(unsigned int i2c_addr, int hrs_btc, int mins_btc);
+extern void ds3231_read_registers(unsigned int i2c_addr,
+                                  unsigned char start_reg,
+                                  volatile void* buf,
+                                  unsigned int count);
+extern void ds3231_write_registers(unsigned int i2c_addr,
+                                   unsigned char start_reg,
+                                   volatile void* buf,
+                                   unsigned int count);
 
 // Global variables/storage.
 volatile unsigned char oled_fb[OLED_FB_SIZE];
 volatile unsigned int time_word;
 volatile unsigned int alarm_word;
 volatile unsigned int time_to_set;
-volatile int cur_hours;
-volatile int cur_minutes;
+// (Time editor values, in DS3231 BCD format.)
+volatile unsigned char cur_hours;
+volatile unsigned char cur_minutes;
 volatile unsigned char cur_state;
 volatile unsigned char cursor_position;
 volatile unsigned char alarm_remember_off;
-volatile unsigned int last_button_state;
+// (Index of the alarm's melody; see tone.h)
+volatile unsigned char alarm_tone;
+// (Seconds for the alarm to ramp up to full volume; 0 = no ramp.)
+volatile unsigned char alarm_ramp_s;
+// (Minutes that Up/Down put the alarm off for; see snooze.h)
+volatile unsigned char alarm_snooze_min;
+volatile unsigned char time_invalid;
 
 #endif
@@ -0,0 +1,182 @@
+#include "input.h"
+
+static void input_push(unsigned int button, unsigned char type,
+                       unsigned int time_us);
+static void input_hold(volatile input_button_t* b, unsigned int pin);
+
+static const unsigned short input_pins[INPUT_NUM_BUTTONS] = {
+    IOA_BUTTON_UP, IOA_BUTTON_SELECT, IOA_BUTTON_DOWN
+};
+
+static volatile input_queue_t input_queue;
+static volatile input_button_t input_buttons[INPUT_NUM_BUTTONS];
+// Debounced levels, as a mask of pressed buttons.
+static volatile unsigned int input_stable;
+
+// This frame's snapshot; see 'input_sample'.
+input_frame_t input_frame;
+
+/*
+ * Reset the queue, and start the backend.
+ */
+void input_init(void) {
+    input_queue.head = 0;
+    input_queue.tail = 0;
+    input_queue.dropped = 0;
+    input_frame.pressed = 0;
+    input_frame.released = 0;
+    input_stable = input_backend_init();
+}
+
+/*
+ * Take the oldest event off the queue. Returns 0 if it was empty.
+ */
+int input_get_event(input_event_t* ev) {
+    unsigned char tail = input_queue.tail;
+    if (tail == input_queue.head) { return 0; }
+    ev->time_us = input_queue.events[tail].time_us;
+    ev->button  = input_queue.events[tail].button;
+    ev->type    = input_queue.events[tail].type;
+    // (Only free the slot once it has been copied out.)
+    __DMB();
+    input_queue.tail = (tail + 1) & (INPUT_QUEUE_SIZE - 1);
+    return 1;
+}
+
+/*
+ * Check whether any events are waiting to be taken.
+ */
+int input_pending(void) {
+    return input_queue.head != input_queue.tail;
+}
+
+/*
+ * Check whether the buttons can be left alone until the next press:
+ * nothing queued, held, or still bouncing.
+ */
+int input_idle(void) {
+    return !input_pending() && !input_stable && input_backend_idle();
+}
+
+/*
+ * Fill in 'input_frame' for a new pass of the main loop.
+ * This takes at most one press off the queue (with any releases
+ * queued ahead of it), so each state handler sees the presses which
+ * were meant for it, however long a pass takes.
+ */
+void input_sample(void) {
+    input_event_t ev;
+    input_frame.pressed = 0;
+    input_frame.released = 0;
+    while (!input_frame.pressed && input_get_event(&ev)) {
+        if (ev.type == INPUT_RELEASE) {
+            input_frame.released |= ev.button;
+            continue;
+        }
+        input_frame.press_us = ev.time_us;
+        if (ev.type == INPUT_REPEAT_FAST) {
+            input_frame.pressed = ev.button | INPUT_FAST;
+        }
+        else if (ev.type == INPUT_LONG) {
+            input_frame.pressed = INPUT_LONG_PRESS(ev.button);
+        }
+        else {
+            input_frame.pressed = ev.button;
+        }
+    }
+    // (The tick updates these; read them all at the same instant.)
+    int i;
+    __disable_irq();
+    input_frame.held = input_stable;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        input_frame.held_ms[i] = (input_stable & input_pins[i]) ?
+                                 input_buttons[i].hold_ms : 0;
+    }
+    __enable_irq();
+}
+
+/*
+ * Time held buttons, and let the backend finish debouncing.
+ * Called from the 1KHz tick.
+ */
+void input_tick(void) {
+    int i;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        if (input_stable & input_pins[i]) {
+            input_hold(&input_buttons[i], input_pins[i]);
+        }
+    }
+    input_backend_tick();
+}
+
+/*
+ * Queue a debounced press or release. Only call this from the
+ * backend's tick, since the tick is the queue's one producer.
+ */
+void input_report(unsigned int button, int down, unsigned int time_us) {
+    if (((input_stable & button) != 0) == (down != 0)) { return; }
+    input_stable ^= button;
+    int i;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        if (input_pins[i] != button) { continue; }
+        // (A short press on a long-press button waits for its release.)
+        if (!(button & INPUT_LONG_PRESS_PINS)) {
+            input_push(button, down ? INPUT_PRESS : INPUT_RELEASE, time_us);
+        }
+        else if (!down) {
+            if (input_buttons[i].hold_ms < INPUT_LONG_PRESS_MS) {
+                input_push(button, INPUT_PRESS, time_us);
+            }
+            input_push(button, INPUT_RELEASE, time_us);
+        }
+        input_buttons[i].hold_ms = 0;
+        input_buttons[i].repeat_ms = INPUT_REPEAT_DELAY_MS;
+    }
+}
+
+/*
+ * Count another millisecond of a button being held, and queue its
+ * auto-repeats or long press when they are due.
+ */
+static void input_hold(volatile input_button_t* b, unsigned int pin) {
+    if (b->hold_ms == INPUT_HOLD_MAX_MS) { return; }
+    unsigned int held = ++b->hold_ms;
+    if ((pin & INPUT_LONG_PRESS_PINS) && held == INPUT_LONG_PRESS_MS) {
+        input_push(pin, INPUT_LONG, timebase_us());
+    }
+    if (!(pin & INPUT_REPEAT_PINS) || held != b->repeat_ms) { return; }
+    unsigned char type = INPUT_REPEAT;
+    if (held >= INPUT_REPEAT_FAST_AFTER) {
+        type = INPUT_REPEAT_FAST;
+        b->repeat_ms += INPUT_REPEAT_FAST_MS;
+    }
+    else if (held >= INPUT_REPEAT_MID_AFTER) {
+        b->repeat_ms += INPUT_REPEAT_MID_MS;
+    }
+    else {
+        b->repeat_ms += INPUT_REPEAT_SLOW_MS;
+    }
+    // (Skipped if the main loop hasn't caught up with the last one.)
+    if (input_queue.head == input_queue.tail) {
+        input_push(pin, type, timebase_us());
+    }
+}
+
+/*
+ * Add an event to the queue, or count it as dropped if it is full.
+ */
+static void input_push(unsigned int button, unsigned char type,
+                       unsigned int time_us) {
+    unsigned char head = input_queue.head;
+    unsigned char next = (head + 1) & (INPUT_QUEUE_SIZE - 1);
+    if (next == input_queue.tail) {
+        ++input_queue.dropped;
+        return;
+    }
+    input_queue.events[head].time_us = time_us;
+    input_queue.events[head].button  = button;
+    input_queue.events[head].type    = type;
+    // (Only publish the slot once it has been filled in.)
+    __DMB();
+    input_queue.head = next;
+}
@@ -0,0 +1,175 @@
+#ifndef _VVC_INPUT_H
+#define _VVC_INPUT_H
+
+#include "global.h"
+#include "timebase.h"
+
+// Button input. A backend debounces the buttons and reports each
+// settled change, stamped with the microsecond timebase of its first
+// edge; that becomes a press or release event in a queue.
+//   input_gpio.c   - A button per pin, with EXTI interrupts. (Default)
+//   input_ladder.c - A resistor ladder on one ADC pin. (INPUT_LADDER=1)
+//   input_touch.c  - Charge-transfer touch pads. (INPUT_TOUCH=1)
+// Whichever is used, buttons are known by their IOA_BUTTON_* masks.
+// Backends report from the 1KHz tick, which is the only producer, and
+// the main loop is the only consumer, so the queue needs no locking.
+// Presses are never lost to a slow main loop, only dropped if more
+// than INPUT_QUEUE_SIZE pile up.
+//
+// The tick also times held buttons. Up/Down auto-repeat, faster the
+// longer they are held: 2Hz, then 8Hz, then 'fast' repeats which the
+// time editors take as 10-minute jumps. Holding Select is a long
+// press. These are queued as events too, but a repeat is only queued
+// if the last one has been taken, so they can't pile up and overshoot
+// after the button is let go. A button with a long press only queues
+// its short press when it is let go, stamped with that edge, and only
+// if the long press wasn't reached; so a handler never acts on the
+// start of a long press.
+#define INPUT_NUM_BUTTONS       3
+#define INPUT_BUTTON_PINS       (IOA_BUTTON_UP | IOA_BUTTON_SELECT | \
+                                 IOA_BUTTON_DOWN)
+#define INPUT_DEBOUNCE_MS       10
+// (Must be a power of 2.)
+#define INPUT_QUEUE_SIZE        16
+// Auto-repeat and long-press timing, in ms held.
+#define INPUT_REPEAT_PINS       (IOA_BUTTON_UP | IOA_BUTTON_DOWN)
+#define INPUT_REPEAT_DELAY_MS   500
+#define INPUT_REPEAT_SLOW_MS    500
+#define INPUT_REPEAT_MID_AFTER  1500
+#define INPUT_REPEAT_MID_MS     125
+#define INPUT_REPEAT_FAST_AFTER 3000
+#define INPUT_REPEAT_FAST_MS    250
+#define INPUT_LONG_PRESS_PINS   IOA_BUTTON_SELECT
+#define INPUT_LONG_PRESS_MS     1000
+#define INPUT_HOLD_MAX_MS       0xFFFF
+
+// Press words in 'input_frame.pressed': the button's pin mask, for
+// presses and repeats alike, plus flags. (Buttons are all on PA0-7.)
+#define INPUT_FAST              0x00010000
+#define INPUT_LONG_PRESS(pin)   ((pin) << 8)
+// Button indices, for 'held_ms'.
+#define INPUT_UP                0
+#define INPUT_SELECT            1
+#define INPUT_DOWN              2
+
+// Event types.
+#define INPUT_RELEASE           0
+#define INPUT_PRESS             1
+#define INPUT_REPEAT            2
+#define INPUT_REPEAT_FAST       3
+#define INPUT_LONG              4
+
+typedef struct {
+    // (Timebase count at the first edge; see timebase.h)
+    unsigned int   time_us;
+    // (IOA_BUTTON_* pin mask)
+    unsigned short button;
+    unsigned char  type;
+} input_event_t;
+
+// Single-producer, single-consumer ring. 'head' is only written by
+// the producer, and 'tail' by the consumer.
+typedef struct {
+    input_event_t events[INPUT_QUEUE_SIZE];
+    unsigned char head;
+    unsigned char tail;
+    unsigned char dropped;
+} input_queue_t;
+
+typedef struct {
+    // How long it has been held, and when it next repeats.
+    unsigned short hold_ms;
+    unsigned short repeat_ms;
+} input_button_t;
+
+// One frame's view of the buttons, sampled once at the top of each
+// pass of the main loop; every state handler reads this instead of
+// the pins or the queue, so they all agree on what happened.
+typedef struct {
+    // Debounced pin mask of buttons down.
+    unsigned int   held;
+    // Press word: the next queued press or repeat, if any.
+    unsigned int   pressed;
+    // Pin mask of buttons let go since the last frame.
+    unsigned int   released;
+    // When 'pressed' happened. (Timebase us of its first edge, or of
+    // the repeat.)
+    unsigned int   press_us;
+    // How long each button has been down, in ms. (INPUT_UP etc.)
+    unsigned short held_ms[INPUT_NUM_BUTTONS];
+} input_frame_t;
+
+extern input_frame_t input_frame;
+
+void input_init(void);
+int input_get_event(input_event_t* ev);
+void input_sample(void);
+int input_pending(void);
+int input_idle(void);
+void input_tick(void);
+void input_report(unsigned int button, int down, unsigned int time_us);
+
+// Backend interface.
+// ('init' sets up the hardware, and returns the buttons already down.
+//  'idle' says whether a press could still wake the chip from Stop
+//  mode, with no debounce in progress; see power.h)
+unsigned int input_backend_init(void);
+void input_backend_tick(void);
+int input_backend_idle(void);
+
+#if defined(VVC_INPUT_TOUCH) && defined(VVC_INPUT_LADDER)
+#error "VVC_INPUT_TOUCH replaces the ladder; don't set VVC_INPUT_LADDER too."
+#endif
+#if defined(VVC_INPUT_TOUCH) && defined(VVC_SERIAL_CONSOLE)
+#error "VVC_INPUT_TOUCH and VVC_SERIAL_CONSOLE both need PA14."
+#endif
+
+#ifdef VVC_INPUT_LADDER
+// Resistor ladder: one pullup to VDD on the ADC pin, and a button to
+// ground through a different resistor for each key. The ADC converts
+// continuously into RAM by DMA, and its analog watchdog is kept on the
+// window of the current key; leaving it raises an interrupt, which
+// starts a debounce like an EXTI edge does. So the CPU only wakes up
+// when the reading changes.
+// (The ADC's DMA request is remapped to channel 2, since the audio
+//  engine uses channel 1; no DMA interrupts are used.)
+// (The pin is IOA_LADDER_PIN; see global.h)
+// (ADC channel 6, for the sequence and for the analog watchdog.)
+#define INPUT_LADDER_CHSEL      ADC_CHSELR_CHSEL6
+#define INPUT_LADDER_AWDCH      (ADC_CFGR1_AWDCH_2 | ADC_CFGR1_AWDCH_1)
+#define INPUT_LADDER_DMA_CHAN   DMA1_Channel2
+// 12-bit readings, for a 10K pullup: Up to ground directly, Select
+// through 2.2K (~740), Down through 6.8K (~1660), and nothing (4095).
+// Each window runs halfway to its neighbours.
+#define INPUT_LADDER_KEYS       4
+#define INPUT_LADDER_MAX        4095
+
+typedef struct {
+    unsigned short low;
+    unsigned short high;
+    unsigned short button;
+} input_ladder_key_t;
+
+void ADC1_IRQ_handler(void);
+#elif defined(VVC_INPUT_TOUCH)
+// Touch pads, measured by charge transfer with plain GPIO, since these
+// chips have no touch sensing controller. Each pad is on its button's
+// pin, through a ~1K resistor, with a sampling capacitor (Cs, ~4.7nF)
+// from that pin to the shared sample pin. Counting the transfers that
+// fill Cs measures the pad's capacitance; a finger raises it, so the
+// count drops. The tick measures one pad every INPUT_TOUCH_SCAN_MS,
+// which takes ~0.2ms, and each pad tracks its own untouched baseline.
+// (The sample pin is IOA_TOUCH_SAMPLE_PIN; see global.h)
+#define INPUT_TOUCH_SCAN_MS     10
+#define INPUT_TOUCH_CONFIRM     2
+#define INPUT_TOUCH_MAX_CYCLES  2000
+// A touch is a drop of more than 1/8 below the baseline, and it ends
+// once the count is back within 1/16 of it.
+#define INPUT_TOUCH_PRESS_DIV   8
+#define INPUT_TOUCH_RELEASE_DIV 16
+#else
+void EXTI0_1_IRQ_handler(void);
+void EXTI4_15_IRQ_handler(void);
+#endif
+
+#endif
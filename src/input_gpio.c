@@ -0,0 +1,115 @@
+#include "input.h"
+
+// A button per pin. (The default input backend; see input.h)
+// Every edge on a button pin raises an EXTI interrupt, which stamps
+// it and masks that pin's line; the tick unmasks it again once the
+// pin has had INPUT_DEBOUNCE_MS to settle, and reports the level.
+// (Port A is every EXTI line's reset mapping, so SYSCFG is untouched.)
+#if !defined(VVC_INPUT_LADDER) && !defined(VVC_INPUT_TOUCH)
+static void input_gpio_exti(void);
+
+static const unsigned short input_gpio_pins[INPUT_NUM_BUTTONS] = {
+    IOA_BUTTON_UP, IOA_BUTTON_SELECT, IOA_BUTTON_DOWN
+};
+
+// Per-button first edge stamps, and ms left until the pin is
+// sampled. (0 = idle)
+static volatile unsigned int input_gpio_edge_us[INPUT_NUM_BUTTONS];
+static volatile unsigned char input_gpio_debounce[INPUT_NUM_BUTTONS];
+
+/*
+ * Set the button pins up as inputs with pullups, and start listening
+ * for their edges.
+ * (GPIO_Pin_N is also EXTI line N's bit, so pin masks work as-is.)
+ */
+unsigned int input_backend_init(void) {
+    int i;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        input_gpio_debounce[i] = 0;
+    }
+    // (A5, A6, A7 unless SPI drives the 595s.)
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = INPUT_BUTTON_PINS;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_IN;
+    gpio_init_struct.GPIO_OType = 0; // N/A for input
+    gpio_init_struct.GPIO_Speed = 0; // N/A for input
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_UP;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+
+    EXTI->RTSR |= INPUT_BUTTON_PINS;
+    EXTI->FTSR |= INPUT_BUTTON_PINS;
+    EXTI->PR    = INPUT_BUTTON_PINS;
+    EXTI->IMR  |= INPUT_BUTTON_PINS;
+    // (Buttons are on lines 0, 1, 5, 6 and 7 across the pinouts.)
+    NVIC_EnableIRQ(EXTI0_1_IRQn);
+    NVIC_EnableIRQ(EXTI4_15_IRQn);
+    return (~GPIOA->IDR) & INPUT_BUTTON_PINS;
+}
+
+/*
+ * Finish debouncing. Called from 'input_tick'.
+ */
+void input_backend_tick(void) {
+    unsigned int level = (~GPIOA->IDR) & INPUT_BUTTON_PINS;
+    int i;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        if (!input_gpio_debounce[i] || --input_gpio_debounce[i]) {
+            continue;
+        }
+        unsigned int pin = input_gpio_pins[i];
+        input_report(pin, level & pin, input_gpio_edge_us[i]);
+        // Drop the bounces, and listen for the next edge. (The EXTI
+        // interrupt can preempt this, so IMR is changed atomically.)
+        EXTI->PR = pin;
+        __disable_irq();
+        EXTI->IMR |= pin;
+        __enable_irq();
+        // An edge between the sample and unmasking would be missed;
+        // fake one so that it gets debounced like any other.
+        if (((~GPIOA->IDR) ^ level) & pin) {
+            EXTI->SWIER = pin;
+        }
+    }
+}
+
+/*
+ * Idle once every button has finished debouncing. (An EXTI line
+ * wakes the chip from Stop mode like any other interrupt.)
+ */
+int input_backend_idle(void) {
+    int i;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        if (input_gpio_debounce[i]) { return 0; }
+    }
+    return 1;
+}
+
+/*
+ * EXTI interrupts: a button pin changed.
+ */
+void EXTI0_1_IRQ_handler(void) {
+    input_gpio_exti();
+}
+
+void EXTI4_15_IRQ_handler(void) {
+    input_gpio_exti();
+}
+
+/*
+ * Start debouncing every button with a pending edge, and mask its
+ * line until that is done.
+ */
+static void input_gpio_exti(void) {
+    unsigned int pending = EXTI->PR & INPUT_BUTTON_PINS;
+    EXTI->IMR &= ~pending;
+    EXTI->PR = pending;
+    unsigned int now = timebase_us();
+    int i;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        if (pending & input_gpio_pins[i]) {
+            input_gpio_edge_us[i] = now;
+            input_gpio_debounce[i] = INPUT_DEBOUNCE_MS;
+        }
+    }
+}
+#endif
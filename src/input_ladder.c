@@ -0,0 +1,130 @@
+#include "input.h"
+
+// Resistor ladder on one ADC pin. ('make INPUT_LADDER=1'; see input.h)
+#ifdef VVC_INPUT_LADDER
+static void input_ladder_watch(const input_ladder_key_t* key);
+
+// Reading windows, from the bottom of the ladder up.
+static const input_ladder_key_t input_ladder_keys[INPUT_LADDER_KEYS] = {
+    { 0,    369,  IOA_BUTTON_UP },
+    { 370,  1198, IOA_BUTTON_SELECT },
+    { 1199, 2877, IOA_BUTTON_DOWN },
+    { 2878, INPUT_LADDER_MAX, 0 },
+};
+
+// Latest reading; written by DMA after every conversion.
+static volatile unsigned short input_ladder_sample;
+// Key being pressed (0 = none), the stamp of the change which is
+// being debounced, and ms left until it is decoded. (0 = idle)
+static volatile unsigned short input_ladder_button;
+static volatile unsigned int input_ladder_edge_us;
+static volatile unsigned char input_ladder_debounce;
+
+/*
+ * Start converting the ladder pin continuously, into RAM.
+ * No key is assumed to be down; if one is, the watchdog fires on
+ * the first conversion and it is debounced as usual.
+ */
+unsigned int input_backend_init(void) {
+    input_ladder_button = 0;
+    input_ladder_debounce = 0;
+    RCC->APB2ENR |= RCC_APB2ENR_ADC1EN | RCC_APB2ENR_SYSCFGEN;
+    RCC->AHBENR  |= RCC_AHBENR_DMA1EN;
+
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOA_LADDER_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_AN;
+    gpio_init_struct.GPIO_OType = 0; // N/A for analog
+    gpio_init_struct.GPIO_Speed = 0; // N/A for analog
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+
+    // Calibrate, with the ADC off.
+    // (PCLK / 4 = 12MHz; 239.5 + 12.5 cycles is a conversion per 21us.)
+    ADC1->CFGR2 = ADC_CFGR2_CKMODE_1;
+    ADC1->CR = ADC_CR_ADCAL;
+    while (ADC1->CR & ADC_CR_ADCAL) {};
+    ADC1->SMPR   = ADC_SMPR_SMP;
+    ADC1->CHSELR = INPUT_LADDER_CHSEL;
+    // Continuous conversions, overwriting unread results, with the
+    // analog watchdog on this channel.
+    ADC1->CFGR1  = ADC_CFGR1_CONT | ADC_CFGR1_OVRMOD |
+                   ADC_CFGR1_DMAEN | ADC_CFGR1_DMACFG |
+                   ADC_CFGR1_AWDEN | ADC_CFGR1_AWDSGL |
+                   INPUT_LADDER_AWDCH;
+
+    // One half-word, over and over, with no interrupts.
+    SYSCFG->CFGR1 |= SYSCFG_CFGR1_ADC_DMA_RMP;
+    INPUT_LADDER_DMA_CHAN->CCR   = 0;
+    INPUT_LADDER_DMA_CHAN->CPAR  = (unsigned int)&ADC1->DR;
+    INPUT_LADDER_DMA_CHAN->CMAR  = (unsigned int)&input_ladder_sample;
+    INPUT_LADDER_DMA_CHAN->CNDTR = 1;
+    INPUT_LADDER_DMA_CHAN->CCR   = DMA_CCR_CIRC | DMA_CCR_PSIZE_0 |
+                                   DMA_CCR_MSIZE_0 | DMA_CCR_EN;
+
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC1->CR  = ADC_CR_ADEN;
+    while (!(ADC1->ISR & ADC_ISR_ADRDY)) {};
+    NVIC_EnableIRQ(ADC1_IRQn);
+    input_ladder_watch(&input_ladder_keys[INPUT_LADDER_KEYS - 1]);
+    return 0;
+}
+
+/*
+ * Decode the reading once it has settled. Called from 'input_tick'.
+ */
+void input_backend_tick(void) {
+    if (!input_ladder_debounce || --input_ladder_debounce) { return; }
+    unsigned int sample = input_ladder_sample;
+    const input_ladder_key_t* key = &input_ladder_keys[0];
+    while (sample > key->high) { ++key; }
+    if (key->button != input_ladder_button) {
+        // (One key at a time; a change is a release, then a press.)
+        if (input_ladder_button) {
+            input_report(input_ladder_button, 0, input_ladder_edge_us);
+        }
+        if (key->button) {
+            input_report(key->button, 1, input_ladder_edge_us);
+        }
+        input_ladder_button = key->button;
+    }
+    input_ladder_watch(key);
+}
+
+/*
+ * Never idle: the ADC stops with the other clocks in Stop mode, so a
+ * press couldn't wake the chip. (It still sleeps between ticks.)
+ */
+int input_backend_idle(void) {
+    return 0;
+}
+
+/*
+ * ADC interrupt: the reading left the current key's window.
+ * Stop watching, and debounce it.
+ */
+void ADC1_IRQ_handler(void) {
+    ADC1->IER = 0;
+    ADC1->ISR = ADC_ISR_AWD;
+    input_ladder_edge_us = timebase_us();
+    input_ladder_debounce = INPUT_DEBOUNCE_MS;
+}
+
+/*
+ * Point the analog watchdog at a key's window, and (re)start
+ * converting. The thresholds can only change while the ADC is
+ * stopped, which takes at most one conversion.
+ * If the reading is already outside the window, the watchdog fires
+ * on the first conversion, so no change is missed.
+ */
+static void input_ladder_watch(const input_ladder_key_t* key) {
+    if (ADC1->CR & ADC_CR_ADSTART) {
+        ADC1->CR |= ADC_CR_ADSTP;
+        while (ADC1->CR & ADC_CR_ADSTP) {};
+    }
+    ADC1->TR  = (key->high << 16) | key->low;
+    ADC1->ISR = ADC_ISR_AWD;
+    ADC1->IER = ADC_IER_AWDIE;
+    ADC1->CR |= ADC_CR_ADSTART;
+}
+#endif
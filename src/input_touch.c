@@ -0,0 +1,152 @@
+#include "input.h"
+
+// Charge-transfer touch pads. ('make INPUT_TOUCH=1'; see input.h)
+#ifdef VVC_INPUT_TOUCH
+static unsigned int input_touch_burst(unsigned int pad);
+static void input_touch_modes(unsigned int mask, unsigned int modes);
+
+static const unsigned short input_touch_pads[INPUT_NUM_BUTTONS] = {
+    IOA_BUTTON_UP, IOA_BUTTON_SELECT, IOA_BUTTON_DOWN
+};
+
+// Untouched cycle count of each pad, in 1/16ths.
+static unsigned int input_touch_base[INPUT_NUM_BUTTONS];
+// Debounced pin mask of pads touched, and per-pad readings in a row
+// which disagree with it, stamped with the first.
+static unsigned int input_touch_down;
+static unsigned char input_touch_count[INPUT_NUM_BUTTONS];
+static unsigned int input_touch_edge_us[INPUT_NUM_BUTTONS];
+// Pad to measure next, and ms until then.
+static unsigned char input_touch_pad;
+static unsigned char input_touch_ms;
+
+/*
+ * Take over the pads and the sample pin, and measure each pad's
+ * baseline. Nothing is assumed to be touched while that runs.
+ */
+unsigned int input_backend_init(void) {
+    // Everything low, which keeps every sampling capacitor empty.
+    GPIOA->BRR = INPUT_BUTTON_PINS | IOA_TOUCH_SAMPLE_PIN;
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = INPUT_BUTTON_PINS |
+                                  IOA_TOUCH_SAMPLE_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_OUT;
+    gpio_init_struct.GPIO_OType = GPIO_OType_PP;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_50MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+
+    int i, j;
+    for (i = 0; i < INPUT_NUM_BUTTONS; ++i) {
+        input_touch_base[i] = 0;
+        for (j = 0; j < 16; ++j) {
+            input_touch_base[i] += input_touch_burst(input_touch_pads[i]);
+        }
+        input_touch_count[i] = 0;
+    }
+    input_touch_down = 0;
+    input_touch_pad = 0;
+    input_touch_ms = INPUT_TOUCH_SCAN_MS;
+    return 0;
+}
+
+/*
+ * Measure one pad every INPUT_TOUCH_SCAN_MS, in turn, and report it
+ * once INPUT_TOUCH_CONFIRM readings in a row agree that it changed.
+ * Called from 'input_tick'.
+ */
+void input_backend_tick(void) {
+    if (--input_touch_ms) { return; }
+    input_touch_ms = INPUT_TOUCH_SCAN_MS;
+    int i = input_touch_pad;
+    input_touch_pad = (i + 1) % INPUT_NUM_BUTTONS;
+
+    unsigned int pad = input_touch_pads[i];
+    unsigned int now = timebase_us();
+    unsigned int cycles = input_touch_burst(pad) * 16;
+    unsigned int base = input_touch_base[i];
+    // A finger adds capacitance, so Cs fills up in fewer cycles.
+    // (With some hysteresis, so a light touch doesn't chatter.)
+    int touched;
+    if (input_touch_down & pad) {
+        touched = cycles < base - base / INPUT_TOUCH_RELEASE_DIV;
+    }
+    else {
+        touched = cycles < base - base / INPUT_TOUCH_PRESS_DIV;
+    }
+    if (!touched) {
+        // Follow slow changes, like temperature and humidity.
+        input_touch_base[i] = base - base / 16 + cycles / 16;
+    }
+
+    if (!touched == !(input_touch_down & pad)) {
+        input_touch_count[i] = 0;
+        return;
+    }
+    if (!input_touch_count[i]++) { input_touch_edge_us[i] = now; }
+    if (input_touch_count[i] < INPUT_TOUCH_CONFIRM) { return; }
+    input_touch_count[i] = 0;
+    input_touch_down ^= pad;
+    input_report(pad, touched, input_touch_edge_us[i]);
+}
+
+/*
+ * Never idle: the pads are only measured from the tick, so a touch
+ * couldn't wake the chip from Stop mode. (It still sleeps between
+ * ticks.)
+ */
+int input_backend_idle(void) {
+    return 0;
+}
+
+/*
+ * Count charge transfers until the sampling capacitor is full.
+ * Each cycle charges the pad to VDD with the sample pin floating, then
+ * floats the pad and grounds the sample pin, which puts the pad and
+ * Cs in parallel and shares the pad's charge into Cs. While the pad is
+ * driven high, the sample pin sits at VDD minus Cs's voltage, so it
+ * reads low once Cs holds most of VDD.
+ * The other pads float throughout, so that their capacitors don't
+ * load the sample pin. Everything is left low, which empties Cs again
+ * before the next burst. (An interrupt in the middle only stretches a
+ * phase; nothing leaks away meanwhile.)
+ */
+static unsigned int input_touch_burst(unsigned int pad) {
+    unsigned int pads_mask = 0, pad_pos = 0, sample_pos = 0, i;
+    for (i = 0; i < 16; ++i) {
+        if (INPUT_BUTTON_PINS & (1 << i)) { pads_mask |= 3 << (i * 2); }
+        if (pad & (1 << i)) { pad_pos = i * 2; }
+        if (IOA_TOUCH_SAMPLE_PIN & (1 << i)) { sample_pos = i * 2; }
+    }
+    unsigned int mask = (3 << pad_pos) | (3 << sample_pos);
+
+    input_touch_modes(pads_mask | mask, 1 << sample_pos);
+    GPIOA->BSRR = pad;
+    unsigned int cycles;
+    for (cycles = 0; cycles < INPUT_TOUCH_MAX_CYCLES; ++cycles) {
+        input_touch_modes(mask, 1 << pad_pos);
+        // (IDR lags the pins by a couple of clock cycles.)
+        __NOP(); __NOP();
+        if (!(GPIOA->IDR & IOA_TOUCH_SAMPLE_PIN)) { break; }
+        input_touch_modes(mask, 1 << sample_pos);
+    }
+    GPIOA->BRR = pad;
+    input_touch_modes(pads_mask | mask,
+                      (pads_mask | mask) & 0x55555555);
+    return cycles;
+}
+
+/*
+ * Set the 'mask' fields of port A's mode register to 'modes'.
+ * Other code changes the port's other pins from interrupts (the buzzer,
+ * and the direct-drive display), so each write is a read-modify-write
+ * with them held off. (Only for the write: a whole burst would stall
+ * them for hundreds of microseconds.)
+ */
+static void input_touch_modes(unsigned int mask, unsigned int modes) {
+    unsigned int primask = __get_PRIMASK();
+    __disable_irq();
+    GPIOA->MODER = (GPIOA->MODER & ~mask) | modes;
+    __set_PRIMASK(primask);
+}
+#endif
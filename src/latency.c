@@ -0,0 +1,88 @@
+#include "latency.h"
+
+// (Only in 'make DIAGNOSTICS=1' builds; see latency.h)
+#ifdef VVC_DIAGNOSTICS
+
+static latency_stats_t latency_stats;
+// The press being followed, if any; whether it has been handled, and
+// whether this frame is the one drawn after that.
+static unsigned char latency_pending;
+static unsigned char latency_handled;
+static unsigned char latency_shown;
+static unsigned int latency_edge_us;
+static unsigned int latency_marks[LATENCY_NUM_STAGES];
+
+/*
+ * Start following a press, from the timestamp of its edge.
+ */
+void latency_start(unsigned int edge_us) {
+    if (latency_pending) { return; }
+    latency_edge_us = edge_us;
+    latency_pending = 1;
+    latency_handled = 0;
+    latency_shown = 0;
+}
+
+/*
+ * Start a new frame. Call before the buttons are sampled.
+ */
+void latency_frame(void) {
+    latency_shown = latency_handled;
+}
+
+/*
+ * Note that a press has reached a stage. Reaching the last one
+ * records the whole press in the statistics.
+ */
+void latency_mark(int stage) {
+    if (!latency_pending) { return; }
+    if (stage == LATENCY_HANDLED) {
+        if (latency_handled) { return; }
+        latency_handled = 1;
+    }
+    // (Drawing and flushing the old state don't count.)
+    else if (!latency_shown) { return; }
+    latency_marks[stage] = timebase_us() - latency_edge_us;
+    if (stage != LATENCY_FLUSHED) { return; }
+    latency_pending = 0;
+    latency_handled = 0;
+    latency_shown = 0;
+
+    // (The first sample sets the minimums.)
+    int i;
+    for (i = 0; i < LATENCY_NUM_STAGES; ++i) {
+        latency_stage_t* s = &latency_stats.stages[i];
+        unsigned int us = latency_marks[i];
+        if (!latency_stats.samples || us < s->min_us) { s->min_us = us; }
+        if (us > s->max_us) { s->max_us = us; }
+        s->sum_us += us;
+    }
+    ++latency_stats.samples;
+
+    unsigned int total = latency_marks[LATENCY_FLUSHED] >> LATENCY_HIST_SHIFT;
+    int bucket = 0;
+    while (total && bucket < (LATENCY_HIST_BUCKETS - 1)) {
+        total >>= 1;
+        ++bucket;
+    }
+    if (latency_stats.hist[bucket] != 0xFFFF) {
+        ++latency_stats.hist[bucket];
+    }
+}
+
+/*
+ * Copy the statistics out. (They are only written from the main
+ * loop, so this needs no locking.)
+ */
+void latency_snapshot(latency_stats_t* out) {
+    *out = latency_stats;
+}
+
+/*
+ * Get a stage's mean latency. (One division; for display rates.)
+ */
+unsigned int latency_avg_us(latency_stats_t* stats, int stage) {
+    if (!stats->samples) { return 0; }
+    return (unsigned int)(stats->stages[stage].sum_us / stats->samples);
+}
+#endif
@@ -0,0 +1,48 @@
+#ifndef _VVC_LATENCY_H
+#define _VVC_LATENCY_H
+
+#include "global.h"
+#include "timebase.h"
+
+// Input-to-photon latency. Each button press handed to the main loop
+// carries the timebase stamp of its edge (see input.h); the loop
+// marks the points after that where the press has been handled by
+// its state's handler, the OLED framebuffer showing the result has
+// been drawn, and the I2C flush which puts it on the screen has
+// finished. Each is kept as a time since the edge, with min/avg/max,
+// and a histogram of the full edge-to-flush time.
+// Handlers draw their page before they look at the buttons, so the
+// frame in which a press is handled still shows the old state; the
+// 'rendered' and 'flushed' marks are taken on the frame after it.
+// (Presses which arrive while one is being followed aren't timed.)
+// (The 7-segment output follows within one 1KHz tick of 'handled'.)
+// Only 'make DIAGNOSTICS=1' builds follow presses, since the page that
+// shows them is only there. (See util_c.h)
+#define LATENCY_HANDLED         0
+#define LATENCY_RENDERED        1
+#define LATENCY_FLUSHED         2
+#define LATENCY_NUM_STAGES      3
+// Histogram buckets double in width: <4ms, <8ms, ... <262ms, more.
+// (Timebase us >> 12, so a 'ms' here is 1.024ms.)
+#define LATENCY_HIST_BUCKETS    8
+#define LATENCY_HIST_SHIFT      12
+
+typedef struct {
+    unsigned int       min_us;
+    unsigned int       max_us;
+    unsigned long long sum_us;
+} latency_stage_t;
+
+typedef struct {
+    unsigned int    samples;
+    latency_stage_t stages[LATENCY_NUM_STAGES];
+    unsigned short  hist[LATENCY_HIST_BUCKETS];
+} latency_stats_t;
+
+void latency_start(unsigned int edge_us);
+void latency_frame(void);
+void latency_mark(int stage);
+void latency_snapshot(latency_stats_t* out);
+unsigned int latency_avg_us(latency_stats_t* stats, int stage);
+
+#endif
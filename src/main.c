@@ -1,5 +1,13 @@
 #include "main.h"
 
+static void task_rtc(void);
+static void task_input(void);
+static void task_sound(void);
+static void task_display(void);
+
+// (So that other tasks can bring the next frame forward.)
+static int task_display_id;
+
 /*
  * Main program. First, run initial setup to set pin functions
  * and enable clocks. Then clear persistent values, and enter the
@@ -23,7 +31,8 @@ int main(void) {
     gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
     GPIO_Init(GPIOA, &gpio_init_struct);
 
-    // Initialize GPIO pins A0, A1, A2, A3 as Push/pull output.
+    // Initialize the 595 clock/data/latch and buzzer pins as
+    // Push/pull output. (A0, A1, A2, A3 unless SPI drives the 595s.)
     gpio_init_struct.GPIO_Pin   = IOA_595_CLOCK_PIN |
                                   IOA_595_DATA_PIN  |
                                   IOA_595_LATCH_PIN |
@@ -33,21 +42,51 @@ int main(void) {
     gpio_init_struct.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(GPIOA, &gpio_init_struct);
 
-    // Initialize GPIO pins A5, A6, A7 as GP input with pullups.
-    gpio_init_struct.GPIO_Pin   = IOA_BUTTON_DOWN   |
-                                  IOA_BUTTON_SELECT |
-                                  IOA_BUTTON_UP;
-    gpio_init_struct.GPIO_Mode  = GPIO_Mode_IN;
-    gpio_init_struct.GPIO_OType = 0; // N/A for input
-    gpio_init_struct.GPIO_Speed = 0; // N/A for input
-    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_UP;
-    GPIO_Init(GPIOA, &gpio_init_struct);
+    // Start the microsecond timebase, and the button input, which
+    // timestamps button edges with it. (The input backend sets up
+    // its own pins.)
+    timebase_init();
+    input_init();
+    // Set up the 7-segment display output, and its dimming schedule.
+    seven_seg_init();
+    brightness_init();
+    // Start the buzzer's timer, and the 1KHz tick which runs the
+    // display's animations, the buzzer's crescendos and the melodies.
+    buzzer_init();
+    seven_seg_anim_init();
+    tick_init();
+    power_init();
+    // Fade in with a greeting; it scrolls by while the rest of the
+    // setup runs.
+    const unsigned char hello[5] = { SEG_GLYPH_H, 0x0E, SEG_GLYPH_L,
+                                     SEG_GLYPH_L, SEG_GLYPH_O };
+    seven_seg_anim_fade_in();
+    seven_seg_anim_scroll(hello, 5, SEVEN_SEG_ANIM_LEFT);
+
+#ifdef VVC_SERIAL_CONSOLE
+    // Start the serial console.
+    console_init();
+#endif
 
     // Initialize the I2C1 peripheral.
     i2c_periph_init(I2C1_BASE, VVC_TIMING_400KHzI2C_48MHzPLL);
 
-    alarm_word = ds3231_get_alarm_1(I2C1_BASE);
-    alarm_word = alarm_word << 8;
+    // Mirror the DS3231's registers with one burst read.
+    ds3231_cache_init();
+    // If the DS3231's oscillator stopped (coin cell died), its time and
+    // alarm are garbage. The status register came in with the burst
+    // above, so this check costs no extra bus transactions.
+    time_invalid = ds3231_cache_osc_stopped();
+    if (time_invalid) {
+        alarm_word = VVC_ALARM_UNSET;
+    }
+    else {
+        alarm_word = ds3231_cache_get_alarm_1();
+        alarm_word = alarm_word << 8;
+    }
+
+    // Start timestamping the DS3231's 1Hz output.
+    rtc_stats_init();
 
     // Initialize the Monochrome OLED screen.
     i2c_init_ssd1306(I2C1_BASE);
@@ -56,68 +95,189 @@ int main(void) {
     time_word = 0;
     cur_state = VVC_STATE_SHOW_TIME;
     cursor_position = 0;
-    last_button_state = 0;
     alarm_remember_off = 0;
+    alarm_tone = 0;
+    alarm_ramp_s = 0;
+    alarm_snooze_min = SNOOZE_DEFAULT_MIN;
+    if (time_invalid) {
+        // Go straight into the 'set time' editor, starting at 00:00.
+        cur_state = VVC_STATE_SET_TIME;
+        cur_hours = 0x00;
+        cur_minutes = 0x00;
+    }
+
+    // Split the work up into tasks, each run as often as it needs.
+    // (The RTC first, so that the first frame has the time. The
+    //  console's 'K' command lists them in this order.)
+    sched_add(task_rtc, TASK_RTC_MS, TASK_RTC_MS / 2);
+    task_display_id = sched_add(task_display, TASK_DISPLAY_MS,
+                                TASK_DISPLAY_MS / 2);
+    sched_add(task_input, TASK_INPUT_MS, TASK_INPUT_MS);
+    sched_add(task_sound, TASK_SOUND_MS, TASK_SOUND_MS);
+#ifdef VVC_SERIAL_CONSOLE
+    sched_add(console_poll, TASK_CONSOLE_MS, TASK_CONSOLE_MS);
+#endif
 
     // Since this is a microcontroller, there's no point in
-    // exiting our program before power-off.
+    // exiting our program before power-off. Idle until the next task
+    // is due. (See power.h)
     while (1) {
-        // Clear the framebuffer.
-        oled_clear_screen(0x00);
-        // Draw an outline.
-        oled_draw_rect(0, 0, 127, 63, 2, 1);
-
-        // Get the current time.
-        time_word = ds3231_get_time(I2C1_BASE);
-        if ((time_word & 0x00FFFF00) == alarm_word) {
-            if (!alarm_remember_off) {
-                cur_state = VVC_STATE_IN_ALARM;
-                cursor_position = 0;
-            }
-        }
-        else {
-            alarm_remember_off = 0;
+        if (!sched_run() && power_idle() == POWER_STOP) {
+            // (The tick stood still, so everything is overdue.)
+            sched_wake_all();
         }
+    }
+}
 
-        if (cur_state == VVC_STATE_SHOW_TIME) {
-            process_show_time_state();
-        }
-        else if (cur_state == VVC_STATE_IN_ALARM) {
-            process_in_alarm_state();
-        }
-        else if (cur_state == VVC_STATE_MENU_PAGE_1) {
-            process_menu_page_1_state();
-        }
-        else if (cur_state == VVC_STATE_MENU_PAGE_2) {
-            process_menu_page_2_state();
-        }
-        else if (cur_state == VVC_STATE_SET_TIME) {
-            process_set_time_state();
-        }
-        else if (cur_state == VVC_STATE_SET_ALARM) {
-            process_set_alarm_state();
-        }
-        else if (cur_state == VVC_STATE_SET_ALARM_DAYS) {
-            process_set_alarm_days_state();
-        }
-        else if (cur_state == VVC_STATE_SET_ALARM_TONE) {
-            process_set_alarm_tone_state();
-        }
-        else if (cur_state == VVC_STATE_SET_ALARM_STATE) {
-            process_set_alarm_state_state();
+/*
+ * RTC task: re-read the time, and check the alarms.
+ */
+static void task_rtc(void) {
+    time_word = ds3231_cache_sync_time();
+    if ((time_word & 0x00FFFF00) == alarm_word) {
+        if (!alarm_remember_off && cur_state != VVC_STATE_IN_ALARM) {
+            cur_state = VVC_STATE_IN_ALARM;
+            cursor_position = 0;
+            sched_wake(task_display_id);
         }
+    }
+    else {
+        alarm_remember_off = 0;
+    }
+    // (The DS3231 times snoozes; this only checks its flag.)
+    if (snooze_task(time_word)) {
+        cur_state = VVC_STATE_IN_ALARM;
+        cursor_position = 0;
+        sched_wake(task_display_id);
+    }
+    rtc_temp_task(time_word);
+}
+
+/*
+ * Input task: presses are queued from interrupts, so this only has
+ * to notice that there are some, and bring the next frame forward to
+ * handle them.
+ */
+static void task_input(void) {
+    if (input_pending()) {
+        sched_wake(task_display_id);
+    }
+}
 
-        // Set 'last button state' value as soon after checking input
-        // as possible. (Checked at the end of state methods)
-        last_button_state = (~GPIOA->IDR) &
-            (IOA_BUTTON_DOWN | IOA_BUTTON_SELECT | IOA_BUTTON_UP);
+/*
+ * Sound task: keep the alarm's melody going while it sounds. (Notes
+ * are played from the tick; this only restarts a finished melody.)
+ */
+static void task_sound(void) {
+    if (cur_state == VVC_STATE_IN_ALARM && !tone_playing()) {
+        tone_play(alarm_tone, 1);
+        // (Starts out barely audible, if a crescendo is set.)
+        buzzer_ramp(alarm_ramp_s * 1000);
+    }
+}
 
+/*
+ * Display task: take the next button press, run the current state's
+ * handler, and send the frame it draws to the OLED.
+ */
+static void task_display(void) {
+    // Clear the framebuffer.
+    oled_clear_screen(0x00);
+    // Draw an outline.
+    oled_draw_rect(0, 0, 127, 63, 2, 1);
 
-        // Display the framebuffer.
-        i2c_display_framebuffer(I2C1_BASE, &oled_fb);
+    // Sample the buttons once, for every handler this frame.
+#ifdef VVC_DIAGNOSTICS
+    latency_frame();
+    input_sample();
+    if (input_frame.pressed) {
+        latency_start(input_frame.press_us);
+    }
+#else
+    input_sample();
+#endif
+    unsigned char last_state = cur_state;
+    // Holding Select leaves any menu or editor without saving.
+    // (Unless the time has to be set, or the alarm is sounding; then
+    //  it is an ordinary Select press.)
+    if (input_frame.pressed & INPUT_LONG_PRESS(IOA_BUTTON_SELECT)) {
+        if (cur_state == VVC_STATE_IN_ALARM || time_invalid) {
+            input_frame.pressed = IOA_BUTTON_SELECT;
+        }
+        else {
+            cur_state = VVC_STATE_SHOW_TIME;
+            cursor_position = 0;
+            // (Stops a tone preview.)
+            tone_stop();
+        }
+    }
+
+    if (cur_state == VVC_STATE_SHOW_TIME) {
+        process_show_time_state();
+    }
+    else if (cur_state == VVC_STATE_IN_ALARM) {
+        process_in_alarm_state();
+    }
+    else if (cur_state == VVC_STATE_MENU_PAGE_1) {
+        process_menu_page_1_state();
+    }
+    else if (cur_state == VVC_STATE_MENU_PAGE_2) {
+        process_menu_page_2_state();
+    }
+    else if (cur_state == VVC_STATE_SET_TIME) {
+        process_set_time_state();
+    }
+    else if (cur_state == VVC_STATE_SET_ALARM) {
+        process_set_alarm_state();
+    }
+    else if (cur_state == VVC_STATE_SET_ALARM_DAYS) {
+        process_set_alarm_days_state();
+    }
+    else if (cur_state == VVC_STATE_SET_ALARM_TONE) {
+        process_set_alarm_tone_state();
+    }
+    else if (cur_state == VVC_STATE_SET_ALARM_STATE) {
+        process_set_alarm_state_state();
+    }
+    else if (cur_state == VVC_STATE_MENU_PAGE_3) {
+        process_menu_page_3_state();
+    }
+    else if (cur_state == VVC_STATE_SET_BRIGHTNESS) {
+        process_set_brightness_state();
+    }
+#ifdef VVC_DIAGNOSTICS
+    else if (cur_state == VVC_STATE_DIAGNOSTICS) {
+        process_diagnostics_state();
+    }
+    else if (cur_state == VVC_STATE_LATENCY) {
+        process_latency_state();
+    }
+    else if (cur_state == VVC_STATE_POWER) {
+        process_power_state();
+    }
+    latency_mark(LATENCY_HANDLED);
+#endif
+    // Handlers draw before they take input, so this frame still shows
+    // the old state; draw the next one right away. (Likewise if more
+    // presses are queued.)
+    if (input_frame.pressed || cur_state != last_state || input_pending()) {
+        sched_wake(task_display_id);
+    }
 
-        // Delay ~500ms. But this is really really bad for input detection
-        // since I'm not using hardware interrupts. So...don't delay.
-        //delay_us(500000);
+    // Follow the dimming schedule, unless the brightness menu is
+    // previewing a level.
+    if (cur_state != VVC_STATE_SET_BRIGHTNESS) {
+        brightness_task(time_word);
     }
+    // (The 7-segment displays are updated from the tick.)
+
+    // Display the framebuffer.
+#ifdef VVC_DIAGNOSTICS
+    latency_mark(LATENCY_RENDERED);
+    i2c_display_framebuffer(I2C1_BASE, &oled_fb);
+    latency_mark(LATENCY_FLUSHED);
+    power_frame_done();
+#else
+    i2c_display_framebuffer(I2C1_BASE, &oled_fb);
+#endif
 }
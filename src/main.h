@@ -3,5 +3,22 @@
 
 #include "global.h"
 #include "util_c.h"
+#include "timebase.h"
+#include "tick.h"
+#include "input.h"
+#include "latency.h"
+#include "sched.h"
+#include "power.h"
+#include "console.h"
+
+// Main loop task periods, in ms. (See sched.h)
+// The screen is redrawn at a governed rate, and right away after a
+// button press; input is queued from interrupts, so the input task
+// only has to notice it.
+#define TASK_RTC_MS             1000
+#define TASK_DISPLAY_MS         100
+#define TASK_INPUT_MS           10
+#define TASK_SOUND_MS           50
+#define TASK_CONSOLE_MS         10
 
 #endif
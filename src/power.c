@@ -0,0 +1,174 @@
+#include "power.h"
+#include "input.h"
+#include "rtc_stats.h"
+#include "seven_seg.h"
+#include "seven_seg_anim.h"
+#include "buzzer.h"
+#include "tone.h"
+
+static int power_can_stop(void);
+static int power_restart_clocks(void);
+static void power_span_add(power_span_t* span, unsigned int us);
+
+static power_stats_t power_stats;
+// End of the last idle period, for the run time.
+static unsigned int power_last_us;
+// A wake-up from Stop mode whose first frame isn't out yet.
+static unsigned char power_frame_pending;
+static unsigned int power_wake_us;
+static unsigned int power_restore_us;
+
+/*
+ * Set up Stop mode. Call after 'timebase_init'.
+ */
+void power_init(void) {
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+    // Stop rather than Standby, with the regulator in low-power mode.
+    PWR->CR = (PWR->CR & ~PWR_CR_PDDS) | PWR_CR_LPDS;
+    // (The RTC's line is only unmasked while stopped; the rest of the
+    //  time, TIM14 captures its edges. See rtc_stats.h)
+    EXTI->FTSR |= POWER_RTC_LINE;
+    power_last_us = timebase_us();
+}
+
+/*
+ * Wait for something to do, in Stop mode if nothing needs the clocks
+ * and Sleep mode otherwise. Interrupts are held off until the clocks
+ * are back, so that the one which woke the chip runs at full speed.
+ * Returns the mode used; after POWER_STOP, the tick has stood still
+ * for up to a second, so every task is overdue.
+ */
+int power_idle(void) {
+    int mode = POWER_SLEEP;
+    __disable_irq();
+    unsigned int start = timebase_us();
+    power_stats.run_us += start - power_last_us;
+    if (power_can_stop()) {
+        EXTI->PR = POWER_RTC_LINE;
+        EXTI->IMR |= POWER_RTC_LINE;
+        SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+        __WFI();
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        unsigned int restore_start = timebase_us();
+        // (An interrupt which was already pending skips Stop mode,
+        //  and leaves the PLL running.)
+        if (power_restart_clocks()) {
+            mode = POWER_STOP;
+            // The timebase counted at HSI speed until just now.
+            power_restore_us = (timebase_us() - restore_start) *
+                               POWER_HSI_SLOWDOWN;
+            power_span_add(&power_stats.restore, power_restore_us);
+            power_wake_us = timebase_us();
+            power_frame_pending = 1;
+        }
+        unsigned int pending = EXTI->PR;
+        EXTI->IMR &= ~POWER_RTC_LINE;
+        EXTI->PR = POWER_RTC_LINE;
+        if (mode == POWER_STOP) {
+            ++power_stats.stops;
+            if (pending & POWER_RTC_LINE) {
+                ++power_stats.rtc_wakes;
+            }
+            else if (pending & INPUT_BUTTON_PINS) {
+                ++power_stats.button_wakes;
+            }
+            // (Before the timebase interrupt sees the waking edge.)
+            rtc_stats_gap();
+        }
+    }
+    else {
+        __WFI();
+        ++power_stats.sleeps;
+        power_stats.sleep_us += timebase_us() - start;
+    }
+    power_last_us = timebase_us();
+    __enable_irq();
+    return mode;
+}
+
+#ifdef VVC_DIAGNOSTICS
+/*
+ * Note that a frame has been sent to the OLED. The first one after a
+ * wake-up from Stop mode is recorded.
+ */
+void power_frame_done(void) {
+    if (!power_frame_pending) { return; }
+    power_frame_pending = 0;
+    power_span_add(&power_stats.frame,
+                   power_restore_us + (timebase_us() - power_wake_us));
+}
+
+/*
+ * Copy the statistics out. (They are only written from the main
+ * loop, so this needs no locking.)
+ */
+void power_snapshot(power_stats_t* out) {
+    *out = power_stats;
+}
+
+/*
+ * Get a stop's mean wake-up cost. (One division; for display rates.)
+ */
+unsigned int power_avg_us(power_stats_t* stats, power_span_t* span) {
+    if (!stats->stops) { return 0; }
+    return (unsigned int)(span->sum_us / stats->stops);
+}
+
+/*
+ * Get the share of the time with the clocks running that was spent in
+ * Sleep mode, in 1/1000ths.
+ */
+unsigned int power_sleep_permille(power_stats_t* stats) {
+    unsigned long long total = stats->sleep_us + stats->run_us;
+    if (!total) { return 0; }
+    return (unsigned int)((stats->sleep_us * 1000) / total);
+}
+
+#endif
+
+/*
+ * Check whether everything that the clock is doing can wait for the
+ * next second or button press, with every clock stopped.
+ * (Called with interrupts off, so nothing can start before the WFI.)
+ */
+static int power_can_stop(void) {
+#ifdef VVC_SERIAL_CONSOLE
+    // (The USART can't receive with its clock stopped.)
+    return 0;
+#else
+    // The 1Hz edges are the only thing that wakes the clock up to
+    // redraw, so they have to be arriving; and they have to be timed
+    // now and then, for the drift statistics.
+    return cur_state == VVC_STATE_SHOW_TIME &&
+           rtc_stats_sqw_ok() && !rtc_stats_measuring() &&
+           input_idle() &&
+           !tone_playing() && !buzzer_active() &&
+           seven_seg_anim_idle() && seven_seg_steady();
+#endif
+}
+
+/*
+ * Switch back to the 48MHz PLL, the way boot sets it up; the PLL's
+ * source and multiplier and the flash wait state survive Stop mode.
+ * Returns 0 if it was still running.
+ */
+static int power_restart_clocks(void) {
+    if ((RCC->CFGR & RCC_CFGR_SWS) == RCC_CFGR_SWS_PLL) { return 0; }
+    RCC->CR |= RCC_CR_HSEON;
+    while (!(RCC->CR & RCC_CR_HSERDY)) {}
+    RCC->CR |= RCC_CR_PLLON;
+    while (!(RCC->CR & RCC_CR_PLLRDY)) {}
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_PLL;
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {}
+    return 1;
+}
+
+/*
+ * Add a wake-up to a cost's min/max/sum. (The first one sets the
+ * minimum; restore and frame are both added once per stop.)
+ */
+static void power_span_add(power_span_t* span, unsigned int us) {
+    if (!span->sum_us || us < span->min_us) { span->min_us = us; }
+    if (us > span->max_us) { span->max_us = us; }
+    span->sum_us += us;
+}
@@ -0,0 +1,65 @@
+#ifndef _VVC_POWER_H
+#define _VVC_POWER_H
+
+#include "global.h"
+#include "timebase.h"
+
+// Power manager, run by the main loop whenever no task is due.
+// Normally that is Sleep mode: the core stops until the next 1KHz
+// tick or any other interrupt, and every peripheral keeps running.
+// On the clock face, when nothing needs a running timer (no sound or
+// animation, no button held or bouncing, and the 7-segment output
+// steady), it is Stop mode instead: every clock stops, the regulator
+// drops into low-power mode, and only EXTI lines can wake the chip.
+// Those are the buttons, and the DS3231's 1Hz output on PA4, whose
+// falling edge starts each second; so the clock still wakes up once
+// a second, to read the time and redraw.
+// Stop mode wakes up on the 8MHz HSI, so the HSE and PLL are started
+// again before any interrupt runs. (I2C1 is clocked from the HSI, so
+// its timing needs nothing; the other peripherals keep their
+// registers.) The timebase and the tick stand still while stopped,
+// so time spent in Stop mode is not counted by either; anything
+// periodic which has to carry on across stops goes by the RTC's time
+// instead. In builds that keep the RTC's drift statistics, they keep
+// the clock awake for a minute in every ten. (See rtc_stats.h)
+#define POWER_RTC_LINE          EXTI_IMR_MR4
+// The timebase counts 6 times slower on the HSI. (48MHz / 8MHz)
+#define POWER_HSI_SLOWDOWN      6
+
+// Idle modes, as returned by 'power_idle'.
+#define POWER_SLEEP             0
+#define POWER_STOP              1
+
+// Wake-up cost, in us.
+typedef struct {
+    unsigned int       min_us;
+    unsigned int       max_us;
+    unsigned long long sum_us;
+} power_span_t;
+
+typedef struct {
+    // Sleep mode: how often, and time spent in and out of it.
+    unsigned int       sleeps;
+    unsigned long long sleep_us;
+    unsigned long long run_us;
+    // Stop mode: how often, and what ended it.
+    unsigned int       stops;
+    unsigned int       rtc_wakes;
+    unsigned int       button_wakes;
+    // Time to get the HSE and PLL running again, and from waking up
+    // to the first frame sent to the OLED. (That includes the first.)
+    power_span_t       restore;
+    power_span_t       frame;
+} power_stats_t;
+
+void power_init(void);
+int power_idle(void);
+// (For the power page, in 'make DIAGNOSTICS=1' builds.)
+#ifdef VVC_DIAGNOSTICS
+void power_frame_done(void);
+void power_snapshot(power_stats_t* out);
+unsigned int power_avg_us(power_stats_t* stats, power_span_t* span);
+unsigned int power_sleep_permille(power_stats_t* stats);
+#endif
+
+#endif
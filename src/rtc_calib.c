@@ -0,0 +1,164 @@
+#include "rtc_calib.h"
+#include "ds3231_cache.h"
+#include "rtc_stats.h"
+#include "timebase.h"
+#include "util_c.h"
+
+static unsigned char rtc_temp_last_min;
+#ifdef VVC_SERIAL_CONSOLE
+static rtc_calib_t rtc_calib;
+#endif
+
+/*
+ * Background task: re-read the DS3231 temperature when the minute
+ * changes, given the current 0xDDhhmmss time word. (The DS3231
+ * converts every 64 seconds. This goes by the RTC's time rather than
+ * the timebase, which stands still in Stop mode; see power.h. The
+ * boot-time register burst already holds a first reading.)
+ */
+void rtc_temp_task(unsigned int time) {
+    unsigned char mins = (time >> 8) & 0x7F;
+    if (mins != rtc_temp_last_min) {
+        rtc_temp_last_min = mins;
+        ds3231_cache_sync_temperature();
+    }
+}
+
+/*
+ * Format the mirrored temperature reading as text, like '23.25C'.
+ * 'buf' must hold at least 10 characters.
+ */
+void rtc_format_temperature(char* buf) {
+    int q = ds3231_cache_get_temperature();
+    int len = 0;
+    if (q < 0) {
+        buf[len++] = '-';
+        q = -q;
+    }
+    len += fmt_int(&buf[len], q >> 2, 1);
+    buf[len++] = '.';
+    len += fmt_int(&buf[len], (q & 0x03) * 25, 2);
+    buf[len++] = 'C';
+    buf[len] = '\0';
+}
+
+/*
+ * Convert a 0x00hhmmss BCD time word to seconds-of-day.
+ */
+unsigned int rtc_time_to_sod(unsigned int time) {
+    unsigned int hrs  = (((time >> 20) & 0x03) * 10) + ((time >> 16) & 0x0F);
+    unsigned int mins = (((time >> 12) & 0x07) * 10) + ((time >> 8) & 0x0F);
+    unsigned int secs = (((time >> 4) & 0x07) * 10) + (time & 0x0F);
+    return (hrs * 3600) + (mins * 60) + secs;
+}
+
+#ifdef VVC_SERIAL_CONSOLE
+
+/*
+ * Find the start of the DS3231's next second by busy-polling its
+ * seconds register. That pins the RTC's sub-second phase down to about
+ * one register read (~100us) instead of a whole second.
+ * Writes the RTC's seconds-of-day at the edge, and the edge's time
+ * relative to 'stamp_us'. Returns 0 if no edge was seen.
+ */
+static int rtc_calib_find_edge(unsigned int stamp_us,
+                               unsigned int* sod,
+                               unsigned int* phase_us) {
+    unsigned int start = timebase_us();
+    unsigned int edge_us;
+    ds3231_cache_refresh(DS3231_REG_SECONDS, 1);
+    unsigned char first = ds3231_cache_get(DS3231_REG_SECONDS);
+    do {
+        edge_us = timebase_us();
+        if ((edge_us - start) > 1500000) { return 0; }
+        ds3231_cache_refresh(DS3231_REG_SECONDS, 1);
+    } while (ds3231_cache_get(DS3231_REG_SECONDS) == first);
+    *phase_us = edge_us - stamp_us;
+    *sod = rtc_time_to_sod(ds3231_cache_sync_time() & 0x00FFFFFF);
+    return 1;
+}
+
+/*
+ * Feed in one reference time: 'ref_s' is a whole-second count from an
+ * accurate source (like a host's Unix time), sent right as that second
+ * started. 'ref_stamp_us' is the timebase value when it arrived.
+ * The first reference starts a calibration window; later ones update
+ * the drift estimate over the whole window.
+ * Returns 0 if the RTC edge could not be found.
+ */
+int rtc_calib_reference(unsigned int ref_s, unsigned int ref_stamp_us) {
+    unsigned int sod;
+    unsigned int phase_us;
+    if (!rtc_calib_find_edge(ref_stamp_us, &sod, &phase_us)) { return 0; }
+    if (!rtc_calib.active) {
+        rtc_calib.active = 1;
+        rtc_calib.have_estimate = 0;
+        rtc_calib.ref_start_s = ref_s;
+        rtc_calib.rtc_start_sod = sod;
+        rtc_calib.phase_start_us = phase_us;
+        return 1;
+    }
+    unsigned int elapsed = ref_s - rtc_calib.ref_start_s;
+    if (elapsed == 0) { return 1; }
+    // Whole seconds gained by the RTC, unwrapped around midnight.
+    unsigned int elapsed_sod = elapsed;
+    while (elapsed_sod >= RTC_SECONDS_PER_DAY) {
+        elapsed_sod -= RTC_SECONDS_PER_DAY;
+    }
+    int d_s = (int)sod - (int)rtc_calib.rtc_start_sod - (int)elapsed_sod;
+    while (d_s > (RTC_SECONDS_PER_DAY / 2)) { d_s -= RTC_SECONDS_PER_DAY; }
+    while (d_s <= -(RTC_SECONDS_PER_DAY / 2)) { d_s += RTC_SECONDS_PER_DAY; }
+    // ...plus the change in sub-second phase. A later edge means the
+    // RTC is falling behind.
+    long long d_us = ((long long)d_s * 1000000) -
+                     ((long long)phase_us - rtc_calib.phase_start_us);
+    // 1us of drift per second is 1ppm, so this is ppm * 1000.
+    long long ppb = (d_us * 1000) / elapsed;
+    rtc_calib.elapsed_s = elapsed;
+    rtc_calib.drift_ppb = (int)ppb;
+    // A fast RTC needs a larger (slower) aging offset. Round to nearest.
+    if (ppb >= 0) {
+        rtc_calib.suggested_delta = (ppb + (RTC_AGING_PPB_PER_LSB / 2)) /
+                                    RTC_AGING_PPB_PER_LSB;
+    }
+    else {
+        rtc_calib.suggested_delta = (ppb - (RTC_AGING_PPB_PER_LSB / 2)) /
+                                    RTC_AGING_PPB_PER_LSB;
+    }
+    rtc_calib.have_estimate = 1;
+    return 1;
+}
+
+/*
+ * Write the suggested correction into the DS3231's aging offset.
+ * The calibration window restarts, since the oscillator changed.
+ * Returns the new aging offset.
+ */
+int rtc_calib_apply(void) {
+    int aging = ds3231_cache_get_aging();
+    if (rtc_calib.have_estimate) {
+        aging += rtc_calib.suggested_delta;
+        if (aging < RTC_AGING_MIN) { aging = RTC_AGING_MIN; }
+        if (aging > RTC_AGING_MAX) { aging = RTC_AGING_MAX; }
+        ds3231_cache_set_aging(aging);
+        rtc_stats_restart();
+    }
+    rtc_calib_stop();
+    return aging;
+}
+
+/*
+ * Abandon the current calibration window.
+ */
+void rtc_calib_stop(void) {
+    rtc_calib.active = 0;
+    rtc_calib.have_estimate = 0;
+}
+
+/*
+ * Get the current calibration state, for reporting.
+ */
+rtc_calib_t* rtc_calib_status(void) {
+    return &rtc_calib;
+}
+#endif
@@ -0,0 +1,41 @@
+#ifndef _VVC_RTC_CALIB_H
+#define _VVC_RTC_CALIB_H
+
+#include "global.h"
+
+// Aging offset trim is ~0.1ppm per LSB; ppm values here are x1000.
+#define RTC_AGING_PPB_PER_LSB   100
+#define RTC_AGING_MIN           -128
+#define RTC_AGING_MAX           127
+
+// Seconds in a day, for unwrapping time-of-day differences.
+#define RTC_SECONDS_PER_DAY     86400
+
+// Temperature readout.
+void rtc_temp_task(unsigned int time);
+void rtc_format_temperature(char* buf);
+unsigned int rtc_time_to_sod(unsigned int time);
+
+#ifdef VVC_SERIAL_CONSOLE
+// Aging-offset calibration against an external reference time.
+// (Reference times come in over the serial console.)
+typedef struct {
+    unsigned char active;
+    unsigned char have_estimate;
+    // First reference point.
+    unsigned int  ref_start_s;
+    unsigned int  rtc_start_sod;
+    unsigned int  phase_start_us;
+    // Latest estimate.
+    unsigned int  elapsed_s;
+    int           drift_ppb;
+    int           suggested_delta;
+} rtc_calib_t;
+
+int rtc_calib_reference(unsigned int ref_s, unsigned int ref_stamp_us);
+int rtc_calib_apply(void);
+void rtc_calib_stop(void);
+rtc_calib_t* rtc_calib_status(void);
+#endif
+
+#endif
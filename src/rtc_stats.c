@@ -0,0 +1,202 @@
+#include "rtc_stats.h"
+#include "ds3231_cache.h"
+#include "timebase.h"
+
+static volatile rtc_stats_t rtc_stats;
+
+/*
+ * Clear the interval statistics. The next edge only sets a new
+ * starting point.
+ */
+static void rtc_stats_clear_intervals(void) {
+    rtc_stats.skip_next = 1;
+    rtc_stats.samples = 0;
+    rtc_stats.sum_dev = 0;
+    rtc_stats.sum_dev_sq = 0;
+    rtc_stats.min_dev = 0x7FFFFFFF;
+    rtc_stats.max_dev = -0x7FFFFFFF;
+    rtc_stats.outliers = 0;
+}
+
+/*
+ * Set the DS3231's SQW/INT pin to a 1Hz square wave, and capture its
+ * falling edges on TIM14 channel 1. (The DS3231 starts each second
+ * on the falling edge.) Call after 'timebase_init' and
+ * 'ds3231_cache_init'; the control register write only happens if the
+ * DS3231 is not already set up that way.
+ */
+void rtc_stats_init(void) {
+    rtc_stats_clear_intervals();
+    rtc_stats.have_edge = 0;
+    rtc_stats.gap = 0;
+    rtc_stats.uptime_s = 0;
+    rtc_stats.resyncs = 0;
+
+    unsigned char ctrl = ds3231_cache_get(DS3231_REG_CONTROL);
+    if (ctrl & (DS3231_CONTROL_INTCN | DS3231_CONTROL_RS_MASK)) {
+        ctrl &= ~(DS3231_CONTROL_INTCN | DS3231_CONTROL_RS_MASK);
+        ds3231_cache_set(DS3231_REG_CONTROL, ctrl);
+        ds3231_cache_commit();
+    }
+
+    // SQW is open-drain, so use the internal pullup.
+    GPIO_PinAFConfig(GPIOA, IOA_RTC_SQW_PINSRC, GPIO_AF_4);
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOA_RTC_SQW_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_AF;
+    gpio_init_struct.GPIO_OType = GPIO_OType_PP;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_2MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_UP;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+
+    // Channel 1 input capture on TI1, with a 'fCK_INT, N=8' filter to
+    // keep the slow open-drain edge from capturing twice.
+    TIMEBASE_TIM->CCMR1 = TIM_CCMR1_CC1S_0 |
+                          TIM_CCMR1_IC1F_1 | TIM_CCMR1_IC1F_0;
+    TIMEBASE_TIM->CCER  = TIM_CCER_CC1P | TIM_CCER_CC1E;
+    TIMEBASE_TIM->SR    = ~TIM_SR_CC1IF;
+    TIMEBASE_TIM->DIER |= TIM_DIER_CC1IE;
+}
+
+/*
+ * Record one SQW edge; called from the timebase interrupt with the
+ * captured timestamp.
+ */
+void rtc_stats_edge(unsigned int stamp_us) {
+#ifndef RTC_STATS_DRIFT
+    rtc_stats.have_edge = 1;
+    rtc_stats.gap = 0;
+    rtc_stats.last_edge_us = stamp_us;
+#else
+    if (!rtc_stats.have_edge) {
+        rtc_stats.have_edge = 1;
+        rtc_stats.last_edge_us = stamp_us;
+        return;
+    }
+    if (rtc_stats.gap) {
+        // (This ends the interval in progress, whatever it measured.)
+        rtc_stats.gap = 0;
+        rtc_stats.skip_next = 0;
+        rtc_stats.last_edge_us = stamp_us;
+        ++rtc_stats.uptime_s;
+        return;
+    }
+    unsigned int interval = stamp_us - rtc_stats.last_edge_us;
+    rtc_stats.last_edge_us = stamp_us;
+    int dev = (int)interval - RTC_STATS_NOMINAL_US;
+    if (dev > RTC_STATS_OUTLIER_US || dev < -RTC_STATS_OUTLIER_US) {
+        // Count the whole seconds anyway, rounded.
+        rtc_stats.uptime_s += (interval + (RTC_STATS_NOMINAL_US / 2)) /
+                              RTC_STATS_NOMINAL_US;
+        if (!rtc_stats.skip_next) { ++rtc_stats.outliers; }
+        rtc_stats.skip_next = 0;
+        return;
+    }
+    ++rtc_stats.uptime_s;
+    if (rtc_stats.skip_next) {
+        rtc_stats.skip_next = 0;
+        return;
+    }
+    ++rtc_stats.samples;
+    rtc_stats.sum_dev += dev;
+    rtc_stats.sum_dev_sq += (unsigned int)(dev * dev);
+    if (dev < rtc_stats.min_dev) { rtc_stats.min_dev = dev; }
+    if (dev > rtc_stats.max_dev) { rtc_stats.max_dev = dev; }
+#endif
+}
+
+/*
+ * Restart the interval statistics; call after changing the DS3231's
+ * oscillator trim, since the old samples no longer apply.
+ */
+void rtc_stats_restart(void) {
+    __disable_irq();
+    rtc_stats_clear_intervals();
+    __enable_irq();
+}
+
+/*
+ * Note that the DS3231's time was stepped by 'step_s' seconds.
+ * Writing the seconds register restarts its countdown chain, so the
+ * interval in progress is left out of the statistics.
+ */
+void rtc_stats_note_resync(int step_s) {
+    __disable_irq();
+    ++rtc_stats.resyncs;
+    rtc_stats.last_resync_s = step_s;
+    rtc_stats.last_resync_uptime_s = rtc_stats.uptime_s;
+    rtc_stats.skip_next = 1;
+    __enable_irq();
+}
+
+/*
+ * Note that the timebase stood still for a while, in Stop mode. Only
+ * an edge or a button press ends that, so the next edge is always one
+ * RTC second after the last one; it is counted, but not measured.
+ * Until it arrives, the square wave isn't taken as working.
+ * (Called with interrupts off, before the waking edge is seen.)
+ */
+void rtc_stats_gap(void) {
+    rtc_stats.gap = 1;
+}
+
+/*
+ * Check whether SQW edges are arriving. The timeout only counts time
+ * with the timebase running, so an edge also has to have been seen
+ * since it last stood still; otherwise, after a button woke the chip,
+ * a square wave which had gone away would look fine to the next stop,
+ * and only another button press would end that one.
+ */
+int rtc_stats_sqw_ok(void) {
+    return rtc_stats.have_edge && !rtc_stats.gap &&
+           ((timebase_us() - rtc_stats.last_edge_us) < RTC_STATS_TIMEOUT_US);
+}
+
+/*
+ * Check whether this is a measurement window, which Stop mode has to
+ * stay out of. (The first interval after a stop is only counted, so
+ * a window gives one less sample than its length.)
+ */
+int rtc_stats_measuring(void) {
+#ifdef RTC_STATS_DRIFT
+    return (rtc_stats.uptime_s % RTC_STATS_PERIOD_S) < RTC_STATS_WINDOW_S;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Copy the statistics out, without an edge landing halfway through.
+ */
+void rtc_stats_snapshot(rtc_stats_t* out) {
+    __disable_irq();
+    *out = *(rtc_stats_t*)&rtc_stats;
+    __enable_irq();
+}
+
+#if defined(VVC_DIAGNOSTICS) || defined(VVC_SERIAL_CONSOLE)
+/*
+ * Turn a snapshot's running sums into mean/variance.
+ * (64-bit divisions; fine at display/console rates, not in the ISR.)
+ */
+void rtc_stats_summary(rtc_stats_t* stats, rtc_stats_summary_t* out) {
+    out->samples = stats->samples;
+    if (!stats->samples) {
+        out->mean_ppb = 0;
+        out->var_q8 = 0;
+        out->min_dev = 0;
+        out->max_dev = 0;
+        return;
+    }
+    long long n = stats->samples;
+    // 1us per second is 1ppm, so this is ppm * 1000.
+    out->mean_ppb = (int)((stats->sum_dev * 1000) / n);
+    // Var = E[x^2] - E[x]^2, both in 8 fractional bits.
+    long long mean_q8 = (stats->sum_dev * 256) / n;
+    long long sq_q8 = (long long)((stats->sum_dev_sq * 256) / n);
+    long long var_q8 = sq_q8 - ((mean_q8 * mean_q8) >> 8);
+    out->var_q8 = (var_q8 > 0) ? (unsigned int)var_q8 : 0;
+    out->min_dev = stats->min_dev;
+    out->max_dev = stats->max_dev;
+}
+#endif
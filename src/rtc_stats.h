@@ -0,0 +1,75 @@
+#ifndef _VVC_RTC_STATS_H
+#define _VVC_RTC_STATS_H
+
+#include "global.h"
+
+// One RTC second, in timebase microseconds.
+#define RTC_STATS_NOMINAL_US    1000000
+// Intervals further than this from one second are missed or extra
+// edges, not drift. (2000ppm is far beyond either crystal's tolerance.)
+#define RTC_STATS_OUTLIER_US    2000
+// No square wave edge for this long means it isn't connected.
+#define RTC_STATS_TIMEOUT_US    2500000
+// The statistics are only kept in builds which can show them; the
+// rest only need to know that edges are arriving. (See power.h)
+#if defined(VVC_DIAGNOSTICS) || defined(VVC_SERIAL_CONSOLE)
+#define RTC_STATS_DRIFT
+#endif
+// Intervals can't be measured across Stop mode, since the timebase
+// stands still. (See power.h) So the first RTC_STATS_WINDOW_S of every
+// RTC_STATS_PERIOD_S seconds of uptime are kept awake to measure them.
+#define RTC_STATS_PERIOD_S      600
+#define RTC_STATS_WINDOW_S      60
+
+// Running statistics, updated from the SQW capture interrupt.
+// Intervals are kept as their deviation from one second, in us; since
+// the timebase runs from the HSE, that is also the HSE's error
+// against the DS3231 in ppm.
+typedef struct {
+    unsigned char      have_edge;
+    unsigned char      skip_next;
+    // The timebase stood still since the last edge. (See power.h)
+    unsigned char      gap;
+    unsigned int       last_edge_us;
+    // Interval deviations.
+    unsigned int       samples;
+    long long          sum_dev;
+    unsigned long long sum_dev_sq;
+    int                min_dev;
+    int                max_dev;
+    // Intervals thrown out as missed or extra edges.
+    unsigned int       outliers;
+    // Whole RTC seconds counted since boot.
+    unsigned int       uptime_s;
+    // Corrections to the DS3231's time (from setting the clock).
+    unsigned int       resyncs;
+    int                last_resync_s;
+    unsigned int       last_resync_uptime_s;
+} rtc_stats_t;
+
+// Fixed-point view of the running sums.
+typedef struct {
+    unsigned int samples;
+    // Mean deviation, in parts-per-billion. Positive means the HSE is
+    // running fast compared to the DS3231.
+    int          mean_ppb;
+    // Variance of the deviation, in us^2 (24.8 fixed-point).
+    unsigned int var_q8;
+    int          min_dev;
+    int          max_dev;
+} rtc_stats_summary_t;
+
+void rtc_stats_init(void);
+void rtc_stats_edge(unsigned int stamp_us);
+void rtc_stats_restart(void);
+void rtc_stats_note_resync(int step_s);
+void rtc_stats_gap(void);
+int rtc_stats_sqw_ok(void);
+int rtc_stats_measuring(void);
+void rtc_stats_snapshot(rtc_stats_t* out);
+// (For the diagnostics page and the console; see util_c.h)
+#if defined(VVC_DIAGNOSTICS) || defined(VVC_SERIAL_CONSOLE)
+void rtc_stats_summary(rtc_stats_t* stats, rtc_stats_summary_t* out);
+#endif
+
+#endif
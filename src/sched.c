@@ -0,0 +1,80 @@
+#include "sched.h"
+
+static sched_task_t sched_tasks[SCHED_MAX_TASKS];
+static int sched_num_tasks;
+
+/*
+ * Add a task, due right away and then every 'period_ms'.
+ * Returns its ID, or -1 if the table is full.
+ */
+int sched_add(sched_fn_t fn, unsigned int period_ms,
+              unsigned int deadline_ms) {
+    if (sched_num_tasks >= SCHED_MAX_TASKS) { return -1; }
+    sched_task_t* t = &sched_tasks[sched_num_tasks];
+    t->fn = fn;
+    t->period_ms = period_ms;
+    t->deadline_ms = deadline_ms;
+    t->next_ms = tick_ms();
+    t->runs = 0;
+    t->late = 0;
+    t->last_us = 0;
+    t->max_us = 0;
+    return sched_num_tasks++;
+}
+
+/*
+ * Make a task due now, instead of at the end of its period.
+ * (Say, to redraw the screen as soon as a button is pressed.)
+ */
+void sched_wake(int task) {
+    sched_tasks[task].next_ms = tick_ms();
+}
+
+/*
+ * Make every task due now. (After the tick has stood still; see
+ * power.h)
+ */
+void sched_wake_all(void) {
+    int i;
+    for (i = 0; i < sched_num_tasks; ++i) {
+        sched_wake(i);
+    }
+}
+
+/*
+ * Run every task which is due, once. Returns the number that ran.
+ */
+int sched_run(void) {
+    int ran = 0;
+    int i;
+    for (i = 0; i < sched_num_tasks; ++i) {
+        sched_task_t* t = &sched_tasks[i];
+        unsigned int now = tick_ms();
+        // (Signed, so that the tick count can wrap.)
+        int behind = (int)(now - t->next_ms);
+        if (behind < 0) { continue; }
+        if (behind > t->deadline_ms) { ++t->late; }
+        if (behind >= t->period_ms) {
+            t->next_ms = now + t->period_ms;
+        }
+        else {
+            t->next_ms += t->period_ms;
+        }
+
+        unsigned int start = timebase_us();
+        t->fn();
+        t->last_us = timebase_us() - start;
+        if (t->last_us > t->max_us) { t->max_us = t->last_us; }
+        ++t->runs;
+        ++ran;
+    }
+    return ran;
+}
+
+int sched_count(void) {
+    return sched_num_tasks;
+}
+
+sched_task_t* sched_task(int task) {
+    return &sched_tasks[task];
+}
@@ -0,0 +1,40 @@
+#ifndef _VVC_SCHED_H
+#define _VVC_SCHED_H
+
+#include "global.h"
+#include "tick.h"
+#include "timebase.h"
+
+// Cooperative scheduler for the main loop's periodic work.
+// Tasks run from 'sched_run', in the order that they were added,
+// whenever the 1KHz tick says that they are due. Each one has a
+// period, and a deadline after which a late start is counted; if a
+// task falls more than a whole period behind, its missed runs are
+// skipped instead of run back-to-back. Run times are measured with
+// the microsecond timebase.
+// (Work which has to stay smooth runs in the tick itself; see tick.h)
+#define SCHED_MAX_TASKS         6
+
+typedef void (*sched_fn_t)(void);
+
+typedef struct {
+    sched_fn_t     fn;
+    unsigned short period_ms;
+    unsigned short deadline_ms;
+    unsigned int   next_ms;
+    // Statistics.
+    unsigned int   runs;
+    unsigned int   late;
+    unsigned int   last_us;
+    unsigned int   max_us;
+} sched_task_t;
+
+int sched_add(sched_fn_t fn, unsigned int period_ms,
+              unsigned int deadline_ms);
+void sched_wake(int task);
+void sched_wake_all(void);
+int sched_run(void);
+int sched_count(void);
+sched_task_t* sched_task(int task);
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef _VVC_SEG_TABLE_H
+#define _VVC_SEG_TABLE_H
+
+/*
+ * 7-segment wiring map and glyph descriptions.
+ *
+ *       a
+ *      ---
+ *   f |   | b
+ *      -g-
+ *   e |   | c
+ *      ---  .dp
+ *       d
+ *
+ * Board wiring: which bit of a digit's byte drives each segment.
+ * Bytes are shifted out LSB first, so bit N ends up on 595 output
+ * Q(7-N). This is the only place that the wiring is described.
+ */
+#define SEG_B               0x01    // Q7: top-right
+#define SEG_A               0x02    // Q6: top
+#define SEG_F               0x04    // Q5: top-left
+#define SEG_G               0x08    // Q4: middle
+#define SEG_C               0x10    // Q3: bottom-right
+#define SEG_D               0x20    // Q2: bottom
+#define SEG_E               0x40    // Q1: bottom-left
+#define SEG_DP              0x80    // Q0: decimal point
+
+// Glyph codes. 0x00-0x0F are the hex digits, so a BCD/hex nibble is
+// its own glyph code. The decimal point is a separate flag which can
+// be OR'd onto any glyph.
+#define SEG_GLYPH_L         0x10
+#define SEG_GLYPH_N         0x11
+#define SEG_GLYPH_R         0x12
+#define SEG_GLYPH_LOWER_O   0x13
+#define SEG_GLYPH_H         0x14
+#define SEG_GLYPH_P         0x15
+#define SEG_GLYPH_U         0x16
+#define SEG_GLYPH_T         0x17
+#define SEG_GLYPH_Y         0x18
+#define SEG_GLYPH_DASH      0x19
+#define SEG_GLYPH_BLANK     0x1A
+// (Letters which look like digits.)
+#define SEG_GLYPH_O         0x00
+#define SEG_GLYPH_S         0x05
+// Table size, and the glyph code bits which index it.
+#define SEG_TABLE_SIZE      0x20
+#define SEG_GLYPH_INDEX     0x1F
+#define SEG_GLYPH_DP        0x80
+
+/*
+ * Glyph descriptions: glyph code, lit segments. The segment table is
+ * built from this list by the compiler, through the wiring map above.
+ * Unlisted codes are blank, rather than silently showing a '0'.
+ */
+#define SEG_GLYPH_LIST(X) \
+    X(0x00,              SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F) \
+    X(0x01,              SEG_B | SEG_C) \
+    X(0x02,              SEG_A | SEG_B | SEG_G | SEG_E | SEG_D) \
+    X(0x03,              SEG_A | SEG_B | SEG_G | SEG_C | SEG_D) \
+    X(0x04,              SEG_F | SEG_G | SEG_B | SEG_C) \
+    X(0x05,              SEG_A | SEG_F | SEG_G | SEG_C | SEG_D) \
+    X(0x06,              SEG_F | SEG_G | SEG_E | SEG_D | SEG_C) \
+    X(0x07,              SEG_A | SEG_B | SEG_C) \
+    X(0x08,              SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | \
+                         SEG_G) \
+    X(0x09,              SEG_A | SEG_B | SEG_F | SEG_G | SEG_C) \
+    X(0x0A,              SEG_A | SEG_B | SEG_C | SEG_E | SEG_F | SEG_G) \
+    X(0x0B,              SEG_C | SEG_D | SEG_E | SEG_F | SEG_G) \
+    X(0x0C,              SEG_A | SEG_D | SEG_E | SEG_F) \
+    X(0x0D,              SEG_B | SEG_C | SEG_D | SEG_E | SEG_G) \
+    X(0x0E,              SEG_A | SEG_D | SEG_E | SEG_F | SEG_G) \
+    X(0x0F,              SEG_A | SEG_E | SEG_F | SEG_G) \
+    X(SEG_GLYPH_L,       SEG_D | SEG_E | SEG_F) \
+    X(SEG_GLYPH_N,       SEG_C | SEG_E | SEG_G) \
+    X(SEG_GLYPH_R,       SEG_E | SEG_G) \
+    X(SEG_GLYPH_LOWER_O, SEG_C | SEG_D | SEG_E | SEG_G) \
+    X(SEG_GLYPH_H,       SEG_B | SEG_C | SEG_E | SEG_F | SEG_G) \
+    X(SEG_GLYPH_P,       SEG_A | SEG_B | SEG_E | SEG_F | SEG_G) \
+    X(SEG_GLYPH_U,       SEG_B | SEG_C | SEG_D | SEG_E | SEG_F) \
+    X(SEG_GLYPH_T,       SEG_D | SEG_E | SEG_F | SEG_G) \
+    X(SEG_GLYPH_Y,       SEG_B | SEG_C | SEG_D | SEG_F | SEG_G) \
+    X(SEG_GLYPH_DASH,    SEG_G) \
+    X(SEG_GLYPH_BLANK,   0)
+
+#endif
@@ -0,0 +1,177 @@
+#include "seven_seg.h"
+#include "bcd.h"
+
+// Display 'on' time for each brightness level. (Gamma 2.2, so the
+// steps look even; the top level keeps the digits on all the time.)
+static const unsigned short seven_seg_duty_levels[SEVEN_SEG_BRIGHTNESS_MAX + 1] = {
+    0, 11, 49, 119, 224, 365, 545, 766,
+    1027, 1331, 1678, 2070, 2506, 2989, 3518, SEVEN_SEG_DUTY_FULL
+};
+
+// The segment word which the backend is currently showing.
+static unsigned int seven_seg_latched;
+// Display controller framebuffer.
+static volatile seven_seg_fb_t seven_seg_fb;
+// Current fade scale. (SEVEN_SEG_FADE_FULL = no fade)
+static volatile unsigned int seven_seg_fade;
+// Current duty cycle.
+static volatile unsigned int seven_seg_duty;
+
+// Segment table, built from the glyph list in seg_table.h.
+#define SEG_TABLE_ENTRY(glyph, segs) [glyph] = (segs),
+static const unsigned char seven_seg_table[SEG_TABLE_SIZE] = {
+    SEG_GLYPH_LIST(SEG_TABLE_ENTRY)
+};
+
+/*
+ * Set up the display backend, and start from a known state.
+ */
+void seven_seg_init(void) {
+    seven_seg_backend_init();
+    seven_seg_set_glyphs(SEG_GLYPH_BLANK, SEG_GLYPH_BLANK,
+                         SEG_GLYPH_BLANK, SEG_GLYPH_BLANK);
+    seven_seg_fb.blink_mask = 0;
+    seven_seg_fb.blink_phase = 0;
+    seven_seg_fb.dp_mask = 0;
+    seven_seg_fade = SEVEN_SEG_FADE_FULL;
+    seven_seg_latched = 0x00000000;
+    seven_seg_backend_show(seven_seg_latched);
+    seven_seg_set_brightness(SEVEN_SEG_BRIGHTNESS_MAX);
+}
+
+/*
+ * Show a segment word. The backend is only updated if it differs
+ * from the current one, so most frames cost one compare; blinking is
+ * just a different word every blink half-period.
+ */
+void seven_seg_commit(unsigned int seg_word) {
+    if (seg_word == seven_seg_latched) { return; }
+    seven_seg_latched = seg_word;
+    seven_seg_backend_show(seg_word);
+}
+
+/*
+ * Get the segments for a glyph code (see seg_table.h).
+ */
+unsigned char seven_seg_encode(unsigned char glyph) {
+    unsigned char segs = seven_seg_table[glyph & SEG_GLYPH_INDEX];
+    if (glyph & SEG_GLYPH_DP) { segs |= SEG_DP; }
+    return segs;
+}
+
+/*
+ * Show a BCD hours/minutes pair. (BCD nibbles are glyph codes.)
+ */
+void seven_seg_set_time(unsigned char hrs_bcd, unsigned char mins_bcd) {
+    seven_seg_set_glyphs(BCD_TENS(hrs_bcd), BCD_ONES(hrs_bcd),
+                         BCD_TENS(mins_bcd), BCD_ONES(mins_bcd));
+}
+
+/*
+ * Show four glyph codes, left to right.
+ */
+void seven_seg_set_glyphs(unsigned char g3, unsigned char g2,
+                          unsigned char g1, unsigned char g0) {
+    // (One store; the animation tick can read the digits at any time.)
+    seven_seg_fb.digits.word = (g3 << 24) | (g2 << 16) | (g1 << 8) | g0;
+}
+
+/*
+ * Set which digits blink.
+ */
+void seven_seg_set_blink(unsigned char digit_mask) {
+    seven_seg_fb.blink_mask = digit_mask;
+}
+
+/*
+ * Set which blinking digits are shown while the others are hidden.
+ */
+void seven_seg_set_blink_phase(unsigned char digit_mask) {
+    seven_seg_fb.blink_phase = digit_mask;
+}
+
+unsigned char seven_seg_get_blink(void) {
+    return seven_seg_fb.blink_mask;
+}
+
+/*
+ * Set which digits' decimal points are lit.
+ */
+void seven_seg_set_dp(unsigned char digit_mask) {
+    seven_seg_fb.dp_mask = digit_mask;
+}
+
+/*
+ * Set the brightness level, 0 (off) to SEVEN_SEG_BRIGHTNESS_MAX.
+ * This is called from the main loop and from the tick's fades, so the
+ * update is kept atomic; otherwise a fade step could land between the
+ * level and the backend's duty (or the direct scan's tables).
+ */
+void seven_seg_set_brightness(unsigned char level) {
+    if (level > SEVEN_SEG_BRIGHTNESS_MAX) {
+        level = SEVEN_SEG_BRIGHTNESS_MAX;
+    }
+    unsigned int primask = __get_PRIMASK();
+    __disable_irq();
+    seven_seg_fb.brightness = level;
+    seven_seg_duty = (seven_seg_duty_levels[level] * seven_seg_fade) >> 8;
+    seven_seg_backend_duty(seven_seg_duty);
+    __set_PRIMASK(primask);
+}
+
+unsigned char seven_seg_get_brightness(void) {
+    return seven_seg_fb.brightness;
+}
+
+/*
+ * Check whether the displays would look the same with every clock
+ * stopped: fully on or off, so the PWM output is a steady level, and
+ * no segment word on its way out. (See power.h)
+ */
+int seven_seg_steady(void) {
+    return (seven_seg_duty == 0 || seven_seg_duty >= SEVEN_SEG_DUTY_FULL) &&
+           seven_seg_backend_idle();
+}
+
+/*
+ * Scale the duty cycle of the current brightness level.
+ * (0 to SEVEN_SEG_FADE_FULL; fades step through this.)
+ */
+void seven_seg_set_fade(unsigned int scale) {
+    seven_seg_fade = scale;
+    seven_seg_set_brightness(seven_seg_fb.brightness);
+}
+
+/*
+ * Turn the framebuffer into a segment word.
+ * 'blink_off' selects the 'off' half of the blink cycle.
+ */
+unsigned int seven_seg_compose(int blink_off) {
+    unsigned char hidden = seven_seg_fb.blink_mask &
+        (blink_off ? ~seven_seg_fb.blink_phase : seven_seg_fb.blink_phase);
+    if (!seven_seg_fb.brightness) { hidden = SEVEN_SEG_ALL_DIGITS; }
+    unsigned int digits = seven_seg_fb.digits.word;
+    unsigned int seg_word = 0;
+    int i;
+    for (i = SEVEN_SEG_DIGITS - 1; i >= 0; --i) {
+        seg_word <<= 8;
+        if (!(hidden & (0x01 << i))) {
+            seg_word |= seven_seg_encode(digits >> (i * 8));
+            if (seven_seg_fb.dp_mask & (0x01 << i)) { seg_word |= SEG_DP; }
+        }
+    }
+    return seg_word;
+}
+
+/*
+ * Turn four glyph codes (digit 0 first) into a segment word, without
+ * the framebuffer's blink/decimal point masks.
+ */
+unsigned int seven_seg_compose_glyphs(const unsigned char* glyphs) {
+    unsigned int seg_word = 0;
+    int i;
+    for (i = SEVEN_SEG_DIGITS - 1; i >= 0; --i) {
+        seg_word = (seg_word << 8) | seven_seg_encode(glyphs[i]);
+    }
+    return seg_word;
+}
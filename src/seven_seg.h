@@ -0,0 +1,116 @@
+#ifndef _VVC_SEVEN_SEG_H
+#define _VVC_SEVEN_SEG_H
+
+#include "global.h"
+#include "seg_table.h"
+
+// 7-segment display output, through four chained 74HC595s or (with
+// VVC_SEVEN_SEG_DIRECT) scanned straight from GPIO pins.
+// Segment words are active-high, one byte per digit: byte 0 is the
+// minutes 'ones' digit, byte 3 the 'hours tens'. The 595 backends
+// shift byte 0 out first, each byte LSB first. (The displays are
+// common-anode, so the backends invert the word.)
+// Only 'seven_seg_commit' touches the backend, and only when the
+// word differs from the one that is already showing.
+
+// Display controller state. The state handlers only write to this;
+// the animation tick turns it into a segment word. (See seven_seg_anim.h)
+// Digit/mask bit N is byte N of the segment word (0 = minutes 'ones').
+#define SEVEN_SEG_DIGITS            4
+#define SEVEN_SEG_ALL_DIGITS        0x0F
+#define SEVEN_SEG_HOURS_DIGITS      0x0C
+#define SEVEN_SEG_MINUTES_DIGITS    0x03
+// Brightness levels; 0 is off.
+#define SEVEN_SEG_BRIGHTNESS_MAX    15
+typedef struct {
+    // Glyph codes. (See seg_table.h) They are always written as one
+    // word, so the animation tick never sees a half-updated time.
+    union {
+        unsigned char glyph[SEVEN_SEG_DIGITS];
+        unsigned int  word;
+    } digits;
+    // Digits which are hidden during the 'off' half of a blink.
+    unsigned char blink_mask;
+    // Blinking digits which are hidden during the 'on' half instead,
+    // so that two fields can blink in alternation.
+    unsigned char blink_phase;
+    // Digits with their decimal point lit. (On displays with a
+    // colon, it is usually wired as one of these.)
+    unsigned char dp_mask;
+    unsigned char brightness;
+} seven_seg_fb_t;
+
+// Full-scale duty cycle; brightness levels and fades scale this.
+#define SEVEN_SEG_DUTY_FULL         4096
+
+#ifdef VVC_SEVEN_SEG_DIRECT
+// Direct drive: TIM16 steps through one digit per update, 4 digits
+// at 1KHz each. A compare on channel 1 ends each digit's on-time
+// early, for brightness and per-digit duty correction.
+// (48MHz / 12000 = 4KHz; 1 tick = 1/48us.)
+#define SEVEN_SEG_SCAN_TIM          TIM16
+#define SEVEN_SEG_SCAN_IRQn         TIM16_IRQn
+#define SEVEN_SEG_SCAN_TICKS        12000
+// Dead time at the end of every slot, so a digit's segments never
+// bleed into the next one. ('ghosting')
+#define SEVEN_SEG_SCAN_BLANK_TICKS  96
+#define SEVEN_SEG_SCAN_ON_MAX       (SEVEN_SEG_SCAN_TICKS - SEVEN_SEG_SCAN_BLANK_TICKS)
+#if defined(VVC_SEVEN_SEG_SPI)
+#error "VVC_SEVEN_SEG_DIRECT replaces the 74HC595s; don't set VVC_SEVEN_SEG_SPI too."
+#endif
+#if !defined(STM32F031K6)
+#error "VVC_SEVEN_SEG_DIRECT needs port B pins; build for an STM32F031K6 (LQFP32) or larger."
+#endif
+#endif
+
+#ifdef VVC_SEVEN_SEG_SPI
+// SPI1 TX is hard-wired to DMA1 channel 3 on the STM32F0.
+#define SEVEN_SEG_DMA_CHAN      DMA1_Channel3
+#define SEVEN_SEG_DMA_IRQn      DMA1_Channel2_3_IRQn
+// 48MHz PCLK / 8 = 6MHz SCK; 32 bits take ~5.5us.
+// (74HC595s are only rated for ~5MHz at 2V, ~20MHz at 4.5V.)
+#define SEVEN_SEG_SPI_BR        SPI_CR1_BR_1
+#endif
+
+// Brightness PWM on the 595s' shared OE pin. (TIM3 channel 4)
+// 48MHz / 4096 = ~11.7KHz, well past visible flicker.
+#define SEVEN_SEG_PWM_TIM           TIM3
+#define SEVEN_SEG_PWM_PERIOD        SEVEN_SEG_DUTY_FULL
+// Fade scale applied on top of the brightness level; 256 = 1.0.
+#define SEVEN_SEG_FADE_FULL         256
+
+// Display backends. (seven_seg_595.c, seven_seg_direct.c)
+// A backend shows a segment word (the 4-digit buffer), and sets the
+// displays' duty cycle, 0 - SEVEN_SEG_DUTY_FULL. The display
+// controller only ever goes through these. A backend is 'idle' when
+// it would keep showing the same thing with its clocks stopped.
+void seven_seg_backend_init(void);
+void seven_seg_backend_show(unsigned int seg_word);
+void seven_seg_backend_duty(unsigned int duty);
+int seven_seg_backend_idle(void);
+
+void seven_seg_init(void);
+void seven_seg_commit(unsigned int seg_word);
+unsigned char seven_seg_encode(unsigned char glyph);
+// Display controller.
+void seven_seg_set_time(unsigned char hrs_bcd, unsigned char mins_bcd);
+void seven_seg_set_glyphs(unsigned char g3, unsigned char g2,
+                          unsigned char g1, unsigned char g0);
+void seven_seg_set_blink(unsigned char digit_mask);
+void seven_seg_set_blink_phase(unsigned char digit_mask);
+unsigned char seven_seg_get_blink(void);
+void seven_seg_set_dp(unsigned char digit_mask);
+void seven_seg_set_brightness(unsigned char level);
+unsigned char seven_seg_get_brightness(void);
+int seven_seg_steady(void);
+void seven_seg_set_fade(unsigned int scale);
+unsigned int seven_seg_compose(int blink_off);
+unsigned int seven_seg_compose_glyphs(const unsigned char* glyphs);
+#ifdef VVC_SEVEN_SEG_SPI
+void DMA1_chan2_3_IRQ_handler(void);
+#endif
+#ifdef VVC_SEVEN_SEG_DIRECT
+void TIM16_IRQ_handler(void);
+#endif
+
+#endif
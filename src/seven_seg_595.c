@@ -0,0 +1,144 @@
+#include "seven_seg.h"
+
+// 74HC595 display backends: bit-banged, or SPI1 + DMA.
+// Both share the TIM3 PWM brightness control on the OE pin.
+#ifndef VVC_SEVEN_SEG_DIRECT
+static void seven_seg_pwm_init(void);
+
+#ifdef VVC_SEVEN_SEG_SPI
+// DMA source buffer; the 4 bytes go out in memory (little-endian) order.
+static volatile unsigned int seven_seg_tx_word;
+static volatile unsigned char seven_seg_tx_busy;
+
+/*
+ * Set up SPI1 as a TX-only master for the 595 chain, fed by DMA.
+ * SCK = PA5, MOSI = PA7 (AF0); the latch stays a GPIO on PA2.
+ */
+void seven_seg_backend_init(void) {
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_SPI1, ENABLE);
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    GPIO_PinAFConfig(GPIOA, IOA_595_CLOCK_PINSRC, GPIO_AF_0);
+    GPIO_PinAFConfig(GPIOA, IOA_595_DATA_PINSRC, GPIO_AF_0);
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOA_595_CLOCK_PIN | IOA_595_DATA_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_AF;
+    gpio_init_struct.GPIO_OType = GPIO_OType_PP;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_50MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+    GPIOA->BRR = IOA_595_LATCH_PIN;
+
+    // Mode 0, LSB first, 8-bit frames, software NSS.
+    SPI1->CR1 = 0;
+    SPI1->CR2 = (SPI_CR2_DS_2 | SPI_CR2_DS_1 | SPI_CR2_DS_0) |
+                SPI_CR2_TXDMAEN;
+    SPI1->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI |
+                SPI_CR1_LSBFIRST | SEVEN_SEG_SPI_BR;
+    SPI1->CR1 |= SPI_CR1_SPE;
+
+    // Memory -> peripheral, byte-wide, incrementing memory address.
+    SEVEN_SEG_DMA_CHAN->CCR = 0;
+    SEVEN_SEG_DMA_CHAN->CPAR = (unsigned int)&SPI1->DR;
+    SEVEN_SEG_DMA_CHAN->CMAR = (unsigned int)&seven_seg_tx_word;
+    SEVEN_SEG_DMA_CHAN->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE;
+    seven_seg_tx_busy = 0;
+    NVIC_EnableIRQ(SEVEN_SEG_DMA_IRQn);
+
+    seven_seg_pwm_init();
+}
+
+/*
+ * Latch a new segment word. This only queues the 4-byte DMA transfer;
+ * the transfer-complete interrupt pulses the latch. If a transfer is
+ * still running, this waits for it first (a few microseconds at most).
+ */
+void seven_seg_backend_show(unsigned int seg_word) {
+    while (seven_seg_tx_busy) {}
+    seven_seg_tx_busy = 1;
+    seven_seg_tx_word = ~seg_word;
+    SEVEN_SEG_DMA_CHAN->CNDTR = 4;
+    SEVEN_SEG_DMA_CHAN->CCR |= DMA_CCR_EN;
+}
+
+/*
+ * DMA1 channel 2/3 interrupt: the last byte has been handed to SPI1.
+ * It still has to clock out of the TX FIFO before the latch pulse.
+ */
+void DMA1_chan2_3_IRQ_handler(void) {
+    if (DMA1->ISR & DMA_ISR_TCIF3) {
+        DMA1->IFCR = DMA_IFCR_CGIF3;
+        SEVEN_SEG_DMA_CHAN->CCR &= ~DMA_CCR_EN;
+        while (SPI1->SR & (SPI_SR_FTLVL | SPI_SR_BSY)) {}
+        GPIOA->BSRR = IOA_595_LATCH_PIN;
+        GPIOA->BRR = IOA_595_LATCH_PIN;
+        seven_seg_tx_busy = 0;
+    }
+}
+
+int seven_seg_backend_idle(void) {
+    return !seven_seg_tx_busy;
+}
+#else
+/*
+ * Bit-banged backend; the pins are already GPIO outputs.
+ */
+void seven_seg_backend_init(void) {
+    seven_seg_pwm_init();
+}
+
+/*
+ * Shift a new segment word into the 595s, and latch it.
+ * (All 32 bits in one unrolled call; see 'shift_word_out'.)
+ */
+void seven_seg_backend_show(unsigned int seg_word) {
+    // (0 = 'on')
+    shift_word_out(~seg_word, GPIOA, IOA_595_CLOCK_PIN,
+                   IOA_595_DATA_PIN, IOA_595_LATCH_PIN);
+}
+
+/*
+ * The word is latched before 'show' returns.
+ */
+int seven_seg_backend_idle(void) {
+    return 1;
+}
+#endif
+
+/*
+ * Set the OE duty cycle. (0 - SEVEN_SEG_DUTY_FULL)
+ */
+void seven_seg_backend_duty(unsigned int duty) {
+    SEVEN_SEG_PWM_TIM->CCR4 = duty;
+}
+
+/*
+ * Drive the 595s' OE pin (PB1) from TIM3 channel 4 in PWM mode.
+ * Once running, brightness changes are a single CCR4 write; the
+ * compare value is preloaded, so it only takes effect at the start of
+ * the next PWM period and never cuts a pulse short.
+ */
+static void seven_seg_pwm_init(void) {
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOB, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
+    GPIO_PinAFConfig(GPIOB, IOB_595_OE_PINSRC, GPIO_AF_1);
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOB_595_OE_PIN;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_AF;
+    gpio_init_struct.GPIO_OType = GPIO_OType_PP;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_2MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOB, &gpio_init_struct);
+
+    SEVEN_SEG_PWM_TIM->CR1   = 0;
+    SEVEN_SEG_PWM_TIM->PSC   = 0;
+    SEVEN_SEG_PWM_TIM->ARR   = SEVEN_SEG_PWM_PERIOD - 1;
+    SEVEN_SEG_PWM_TIM->CCR4  = 0;
+    // PWM mode 1 with preload: 'active' while CNT < CCR4.
+    SEVEN_SEG_PWM_TIM->CCMR2 = TIM_CCMR2_OC4M_2 | TIM_CCMR2_OC4M_1 |
+                               TIM_CCMR2_OC4PE;
+    // OE is active-low, so 'active' is a low output.
+    SEVEN_SEG_PWM_TIM->CCER  = TIM_CCER_CC4P | TIM_CCER_CC4E;
+    SEVEN_SEG_PWM_TIM->EGR   = TIM_EGR_UG;
+    SEVEN_SEG_PWM_TIM->CR1   = TIM_CR1_ARPE | TIM_CR1_CEN;
+}
+#endif
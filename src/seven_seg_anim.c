@@ -0,0 +1,216 @@
+#include "seven_seg_anim.h"
+
+// Fade curve: OE duty scale per step. (Gamma 2.2 like the brightness
+// levels, so the fade looks even instead of jumping at the top.)
+static const unsigned short seven_seg_anim_fade_curve[SEVEN_SEG_ANIM_FADE_STEPS] = {
+    0, 1, 3, 7, 14, 23, 34, 48,
+    64, 83, 105, 129, 157, 187, 220, SEVEN_SEG_FADE_FULL
+};
+
+// Wipe frames: the segments which are already showing the new word,
+// sweeping left to right one segment column at a time.
+// (Left column: e/f; middle: a/g/d; right: b/c/dp. Digit 3 is on the
+//  left.) Right-to-left wipes use the inverse of the mirrored frame.
+#define WIPE_L      (SEG_E | SEG_F)
+#define WIPE_LM     (WIPE_L | SEG_A | SEG_G | SEG_D)
+static const unsigned int seven_seg_anim_wipe_masks[SEVEN_SEG_ANIM_WIPE_FRAMES] = {
+    0x00000000,
+    (WIPE_L << 24),              (WIPE_LM << 24),              0xFF000000,
+    0xFF000000 | (WIPE_L << 16), 0xFF000000 | (WIPE_LM << 16), 0xFFFF0000,
+    0xFFFF0000 | (WIPE_L << 8),  0xFFFF0000 | (WIPE_LM << 8),  0xFFFFFF00,
+    0xFFFFFF00 | WIPE_L,         0xFFFFFF00 | WIPE_LM,         0xFFFFFFFF
+};
+
+static volatile seven_seg_anim_t seven_seg_anim;
+
+/*
+ * Reset the engine. Call after 'seven_seg_init', and before the tick
+ * starts. Nothing is animating, and the display starts out faded out;
+ * call 'seven_seg_anim_fade_in' to bring it up.
+ */
+void seven_seg_anim_init(void) {
+    seven_seg_anim.frame_ms = 0;
+    seven_seg_anim.blink_ms = 0;
+    seven_seg_anim.blink_off = 0;
+    seven_seg_anim.blink_mask = 0;
+    seven_seg_anim.fade_ms = 0;
+    seven_seg_anim.fade_step = 0;
+    seven_seg_anim.fade_dir = 0;
+    seven_seg_set_fade(seven_seg_anim_fade_curve[0]);
+    seven_seg_anim.scroll_ms = 0;
+    seven_seg_anim.scroll_frames = 0;
+    seven_seg_anim.scroll_pos = 0;
+    seven_seg_anim.wipe_ms = 0;
+    seven_seg_anim.wipe_frame = SEVEN_SEG_ANIM_WIPE_FRAMES;
+    seven_seg_anim.wipe_dir = SEVEN_SEG_ANIM_LEFT;
+    seven_seg_anim.wipe_from = 0;
+    seven_seg_anim.shown = 0;
+}
+
+/*
+ * Advance the animations by one frame, and commit the result.
+ * Called from the 1KHz tick; only every SEVEN_SEG_ANIM_FRAME_MS'th
+ * call does any work.
+ */
+void seven_seg_anim_tick(void) {
+    if (++seven_seg_anim.frame_ms < SEVEN_SEG_ANIM_FRAME_MS) { return; }
+    seven_seg_anim.frame_ms = 0;
+
+    // Blink phase. A new set of blinking digits starts out visible,
+    // so moving the cursor shows the new field right away.
+    unsigned char blink_mask = seven_seg_get_blink();
+    if (blink_mask != seven_seg_anim.blink_mask) {
+        seven_seg_anim.blink_mask = blink_mask;
+        seven_seg_anim_blink_restart();
+    }
+    seven_seg_anim.blink_ms += SEVEN_SEG_ANIM_FRAME_MS;
+    if (seven_seg_anim.blink_ms >= SEVEN_SEG_ANIM_BLINK_MS) {
+        seven_seg_anim.blink_ms = 0;
+        seven_seg_anim.blink_off = !seven_seg_anim.blink_off;
+    }
+
+    // Fade.
+    if (seven_seg_anim.fade_dir) {
+        seven_seg_anim.fade_ms += SEVEN_SEG_ANIM_FRAME_MS;
+        if (seven_seg_anim.fade_ms >= SEVEN_SEG_ANIM_FADE_MS) {
+            seven_seg_anim.fade_ms = 0;
+            seven_seg_anim.fade_step += seven_seg_anim.fade_dir;
+            seven_seg_set_fade(
+                seven_seg_anim_fade_curve[seven_seg_anim.fade_step]);
+            if (seven_seg_anim.fade_step == 0 ||
+                seven_seg_anim.fade_step == SEVEN_SEG_ANIM_FADE_STEPS - 1) {
+                seven_seg_anim.fade_dir = 0;
+            }
+        }
+    }
+
+    // A scroll replaces the framebuffer until its last frame is over.
+    unsigned int seg_word;
+    if (seven_seg_anim.scroll_frames) {
+        seg_word =
+            seven_seg_anim.scroll_words[seven_seg_anim.scroll_pos];
+        seven_seg_anim.scroll_ms += SEVEN_SEG_ANIM_FRAME_MS;
+        if (seven_seg_anim.scroll_ms >= SEVEN_SEG_ANIM_SCROLL_MS) {
+            seven_seg_anim.scroll_ms = 0;
+            if (++seven_seg_anim.scroll_pos >=
+                seven_seg_anim.scroll_frames) {
+                seven_seg_anim.scroll_frames = 0;
+            }
+        }
+    }
+    else {
+        seg_word = seven_seg_compose(seven_seg_anim.blink_off);
+    }
+
+    // A wipe sweeps from the old word to the live one.
+    if (seven_seg_anim.wipe_frame < SEVEN_SEG_ANIM_WIPE_FRAMES) {
+        unsigned int mask;
+        if (seven_seg_anim.wipe_dir == SEVEN_SEG_ANIM_LEFT) {
+            mask = seven_seg_anim_wipe_masks[seven_seg_anim.wipe_frame];
+        }
+        else {
+            mask = ~seven_seg_anim_wipe_masks[
+                SEVEN_SEG_ANIM_WIPE_FRAMES - 1 - seven_seg_anim.wipe_frame];
+        }
+        seg_word = (seg_word & mask) | (seven_seg_anim.wipe_from & ~mask);
+        seven_seg_anim.wipe_ms += SEVEN_SEG_ANIM_FRAME_MS;
+        if (seven_seg_anim.wipe_ms >= SEVEN_SEG_ANIM_WIPE_MS) {
+            seven_seg_anim.wipe_ms = 0;
+            ++seven_seg_anim.wipe_frame;
+        }
+    }
+
+    seven_seg_anim.shown = seg_word;
+    seven_seg_commit(seg_word);
+}
+
+/*
+ * Restart the blink cycle at the start of its 'on' half.
+ * (Editors call this when a value changes, so it is never hidden.)
+ */
+void seven_seg_anim_blink_restart(void) {
+    seven_seg_anim.blink_ms = 0;
+    seven_seg_anim.blink_off = 0;
+}
+
+/*
+ * Fade the display in from dark, or out to dark. A faded-out display
+ * stays dark until the next fade in.
+ */
+void seven_seg_anim_fade_in(void) {
+    seven_seg_anim.fade_ms = 0;
+    seven_seg_anim.fade_dir = 1;
+    if (seven_seg_anim.fade_step == SEVEN_SEG_ANIM_FADE_STEPS - 1) {
+        seven_seg_anim.fade_dir = 0;
+    }
+}
+
+void seven_seg_anim_fade_out(void) {
+    seven_seg_anim.fade_ms = 0;
+    seven_seg_anim.fade_dir = -1;
+    if (seven_seg_anim.fade_step == 0) {
+        seven_seg_anim.fade_dir = 0;
+    }
+}
+
+/*
+ * Scroll a message of glyph codes across the digits, once. Text
+ * scrolling 'left' enters on the right, like a ticker. The frames are
+ * all encoded here, so the tick just steps through them.
+ * (Messages are cut off at SEVEN_SEG_ANIM_SCROLL_MAX glyphs.)
+ */
+void seven_seg_anim_scroll(const unsigned char* glyphs, int len, int dir) {
+    if (len > SEVEN_SEG_ANIM_SCROLL_MAX) { len = SEVEN_SEG_ANIM_SCROLL_MAX; }
+    // Stop any running scroll while its frames are overwritten.
+    seven_seg_anim.scroll_frames = 0;
+    // A glyph takes 3 frames to cross the display after it enters.
+    int frames = len + SEVEN_SEG_DIGITS - 1;
+    int f;
+    for (f = 0; f < frames; ++f) {
+        unsigned char window[SEVEN_SEG_DIGITS];
+        int d;
+        for (d = 0; d < SEVEN_SEG_DIGITS; ++d) {
+            // (Digit 3 is on the left.)
+            int pos = SEVEN_SEG_DIGITS - 1 - d;
+            int i;
+            if (dir == SEVEN_SEG_ANIM_LEFT) {
+                i = f + pos - (SEVEN_SEG_DIGITS - 1);
+            }
+            else {
+                i = len - 1 - f + pos;
+            }
+            window[d] = SEG_GLYPH_BLANK;
+            if (i >= 0 && i < len) { window[d] = glyphs[i]; }
+        }
+        seven_seg_anim.scroll_words[f] = seven_seg_compose_glyphs(window);
+    }
+    seven_seg_anim.scroll_ms = 0;
+    seven_seg_anim.scroll_pos = 0;
+    seven_seg_anim.scroll_frames = frames;
+}
+
+int seven_seg_anim_scrolling(void) {
+    return seven_seg_anim.scroll_frames != 0;
+}
+
+/*
+ * Check whether the tick has nothing left to do: no animation running,
+ * nothing blinking, and the framebuffer already committed.
+ */
+int seven_seg_anim_idle(void) {
+    return !seven_seg_anim.fade_dir && !seven_seg_anim.scroll_frames &&
+           seven_seg_anim.wipe_frame >= SEVEN_SEG_ANIM_WIPE_FRAMES &&
+           !seven_seg_get_blink() &&
+           seven_seg_compose(0) == seven_seg_anim.shown;
+}
+
+/*
+ * Wipe from the segment word 'from' to the framebuffer's contents.
+ * The framebuffer stays live during the wipe.
+ */
+void seven_seg_anim_wipe(unsigned int from, int dir) {
+    seven_seg_anim.wipe_dir = dir;
+    seven_seg_anim.wipe_from = from;
+    seven_seg_anim.wipe_ms = 0;
+    seven_seg_anim.wipe_frame = 0;
+}
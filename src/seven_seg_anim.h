@@ -0,0 +1,65 @@
+#ifndef _VVC_SEVEN_SEG_ANIM_H
+#define _VVC_SEVEN_SEG_ANIM_H
+
+#include "global.h"
+#include "seven_seg.h"
+
+// 7-segment animation engine, run from the 1KHz tick. (See tick.h)
+// Every frame it composes the display controller's framebuffer with
+// the running animations and commits the result, so blinking, fades
+// and scrolling keep their pace no matter how long the main loop
+// spends on the I2C bus. Animations step through precomputed frames;
+// the tick only indexes tables and compares words.
+#define SEVEN_SEG_ANIM_FRAME_MS     10
+// Blink: 250ms on, 250ms off.
+#define SEVEN_SEG_ANIM_BLINK_MS     250
+// Fades: one curve step per 20ms.
+#define SEVEN_SEG_ANIM_FADE_STEPS   16
+#define SEVEN_SEG_ANIM_FADE_MS      20
+// Scrolling: one digit per 250ms.
+#define SEVEN_SEG_ANIM_SCROLL_MAX   12
+#define SEVEN_SEG_ANIM_SCROLL_MS    250
+// Wipes: one segment column per 20ms; 3 columns per digit.
+#define SEVEN_SEG_ANIM_WIPE_FRAMES  13
+#define SEVEN_SEG_ANIM_WIPE_MS      20
+// Directions for scrolls and wipes.
+#define SEVEN_SEG_ANIM_LEFT         0
+#define SEVEN_SEG_ANIM_RIGHT        1
+
+typedef struct {
+    // Milliseconds into the current frame.
+    unsigned char  frame_ms;
+    // Blink phase.
+    unsigned short blink_ms;
+    unsigned char  blink_off;
+    unsigned char  blink_mask;
+    // Fade: curve step, and direction (+1 in, -1 out, 0 idle).
+    unsigned char  fade_ms;
+    unsigned char  fade_step;
+    signed char    fade_dir;
+    // Scroll: precomputed segment words, and the one being shown.
+    // (No frames means no scroll.)
+    unsigned short scroll_ms;
+    unsigned char  scroll_frames;
+    unsigned char  scroll_pos;
+    unsigned int   scroll_words[SEVEN_SEG_ANIM_SCROLL_MAX + 3];
+    // Wipe: the word being wiped away, and the current column mask.
+    unsigned char  wipe_ms;
+    unsigned char  wipe_frame;
+    unsigned char  wipe_dir;
+    unsigned int   wipe_from;
+    // Last committed word.
+    unsigned int   shown;
+} seven_seg_anim_t;
+
+void seven_seg_anim_init(void);
+void seven_seg_anim_tick(void);
+void seven_seg_anim_blink_restart(void);
+void seven_seg_anim_fade_in(void);
+void seven_seg_anim_fade_out(void);
+void seven_seg_anim_scroll(const unsigned char* glyphs, int len, int dir);
+int seven_seg_anim_scrolling(void);
+int seven_seg_anim_idle(void);
+void seven_seg_anim_wipe(unsigned int from, int dir);
+
+#endif
@@ -0,0 +1,132 @@
+#include "seven_seg.h"
+
+// Direct-drive display backend: the digits are multiplexed straight
+// from GPIO pins by the TIM16 interrupt, with no 74HC595s.
+#ifdef VVC_SEVEN_SEG_DIRECT
+static void seven_seg_scan_update(void);
+
+// Per-digit duty correction, by number of lit segments. The digit's
+// high-side switch and the supply sag a little with every lit
+// segment, so a '1' looks brighter than an '8' for the same on-time.
+// (x/256; tune for the board.)
+static const unsigned short seven_seg_scan_comp[9] = {
+    160, 172, 184, 196, 208, 220, 232, 244, 256
+};
+static const unsigned short seven_seg_scan_digit_pins[SEVEN_SEG_DIGITS] = {
+    IOA_DIGIT_0_PIN, IOA_DIGIT_1_PIN, IOA_DIGIT_2_PIN, IOA_DIGIT_3_PIN
+};
+
+// What the scan interrupt shows, per digit: a GPIOB BSRR word for
+// its segments, and the slot tick to switch it on at. Both are
+// worked out ahead of time, so the interrupt only copies them out.
+static volatile unsigned int seven_seg_scan_segs[SEVEN_SEG_DIGITS];
+static volatile unsigned short seven_seg_scan_start[SEVEN_SEG_DIGITS];
+static volatile unsigned char seven_seg_scan_digit;
+// Inputs for the tables above.
+static unsigned int seven_seg_scan_word;
+static unsigned int seven_seg_scan_duty;
+
+/*
+ * Set up the segment/digit pins, and start scanning on TIM16.
+ * (Everything starts out dark.)
+ */
+void seven_seg_backend_init(void) {
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOB, ENABLE);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM16, ENABLE);
+    GPIOA->BSRR = IOA_DIGIT_PINS;
+    GPIOB->BSRR = IOB_SEG_PINS;
+    GPIO_InitTypeDef gpio_init_struct;
+    gpio_init_struct.GPIO_Pin   = IOA_DIGIT_PINS;
+    gpio_init_struct.GPIO_Mode  = GPIO_Mode_OUT;
+    gpio_init_struct.GPIO_OType = GPIO_OType_PP;
+    gpio_init_struct.GPIO_Speed = GPIO_Speed_10MHz;
+    gpio_init_struct.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOA, &gpio_init_struct);
+    gpio_init_struct.GPIO_Pin   = IOB_SEG_PINS;
+    GPIO_Init(GPIOB, &gpio_init_struct);
+
+    seven_seg_scan_word = 0;
+    seven_seg_scan_duty = 0;
+    seven_seg_scan_digit = 0;
+    seven_seg_scan_update();
+
+    // Channel 1 is a plain compare (no output), only for its flag.
+    SEVEN_SEG_SCAN_TIM->CR1   = 0;
+    SEVEN_SEG_SCAN_TIM->PSC   = 0;
+    SEVEN_SEG_SCAN_TIM->ARR   = SEVEN_SEG_SCAN_TICKS - 1;
+    SEVEN_SEG_SCAN_TIM->CCR1  = SEVEN_SEG_SCAN_TICKS;
+    SEVEN_SEG_SCAN_TIM->CCMR1 = 0;
+    SEVEN_SEG_SCAN_TIM->EGR   = TIM_EGR_UG;
+    SEVEN_SEG_SCAN_TIM->SR    = 0;
+    SEVEN_SEG_SCAN_TIM->DIER  = TIM_DIER_UIE | TIM_DIER_CC1IE;
+    // Late scan interrupts show up as uneven digits, so this one
+    // outranks everything else.
+    NVIC_SetPriority(SEVEN_SEG_SCAN_IRQn, 0);
+    NVIC_EnableIRQ(SEVEN_SEG_SCAN_IRQn);
+    SEVEN_SEG_SCAN_TIM->CR1   = TIM_CR1_CEN;
+}
+
+void seven_seg_backend_show(unsigned int seg_word) {
+    seven_seg_scan_word = seg_word;
+    seven_seg_scan_update();
+}
+
+void seven_seg_backend_duty(unsigned int duty) {
+    seven_seg_scan_duty = duty;
+    seven_seg_scan_update();
+}
+
+/*
+ * Never idle; only one digit is lit at a time, so the scan can't stop.
+ */
+int seven_seg_backend_idle(void) {
+    return 0;
+}
+
+/*
+ * Rebuild the scan interrupt's per-digit tables.
+ * A digit is switched on at 'SCAN_TICKS - on-time' into its slot and
+ * off at the end of it, so the segments always change while every
+ * digit is dark. A digit with no on-time is never switched on.
+ */
+static void seven_seg_scan_update(void) {
+    unsigned int on_max = (seven_seg_scan_duty * SEVEN_SEG_SCAN_ON_MAX) /
+                          SEVEN_SEG_DUTY_FULL;
+    int d;
+    for (d = 0; d < SEVEN_SEG_DIGITS; ++d) {
+        unsigned int segs = (seven_seg_scan_word >> (d * 8)) & 0xFF;
+        unsigned int lit = 0;
+        unsigned int s;
+        for (s = segs; s; s >>= 1) { lit += s & 0x01; }
+        unsigned int on = (on_max * seven_seg_scan_comp[lit]) >> 8;
+        // (Segments are active-low: lit bits are reset, others set.)
+        seven_seg_scan_segs[d] = (segs << 16) | (~segs & IOB_SEG_PINS);
+        seven_seg_scan_start[d] = SEVEN_SEG_SCAN_TICKS - on;
+    }
+}
+
+/*
+ * TIM16 interrupt: the multiplexing scan.
+ * Update (slot start): all digits off, then the next digit's segments
+ * and switch-on time. Compare 1: switch that digit on.
+ * This runs 8000 times a second, so it is kept branch-light and has
+ * no loops. Worst case (both flags at once) it is ~45 instructions,
+ * ~60 cycles; with exception entry/exit and the flash wait state,
+ * ~100 cycles, or ~2us at 48MHz. That is under 1% of the CPU.
+ */
+void TIM16_IRQ_handler(void) {
+    unsigned int sr = SEVEN_SEG_SCAN_TIM->SR;
+    SEVEN_SEG_SCAN_TIM->SR = ~sr;
+    unsigned int d = seven_seg_scan_digit;
+    if (sr & TIM_SR_UIF) {
+        GPIOA->BSRR = IOA_DIGIT_PINS;
+        d = (d + 1) & (SEVEN_SEG_DIGITS - 1);
+        seven_seg_scan_digit = d;
+        GPIOB->BSRR = seven_seg_scan_segs[d];
+        SEVEN_SEG_SCAN_TIM->CCR1 = seven_seg_scan_start[d];
+    }
+    if (sr & TIM_SR_CC1IF) {
+        GPIOA->BRR = seven_seg_scan_digit_pins[d];
+    }
+}
+#endif
@@ -0,0 +1,57 @@
+#include "snooze.h"
+
+static volatile snooze_t snooze;
+
+/*
+ * Snooze the alarm: arm the DS3231's alarm 2 for 'alarm_snooze_min'
+ * minutes past 'time' (a 0xddhhmmss time word).
+ */
+void snooze_start(unsigned int time) {
+    snooze.wake_time = bcd_add_minutes((time >> 8) & 0x3F7F,
+                                       bcd_from_bin(alarm_snooze_min));
+    ds3231_cache_set_alarm_2_time(snooze.wake_time >> 8,
+                                  snooze.wake_time & 0xFF);
+    // (This minute never matches, so there's nothing to check in it.)
+    snooze.checked_minute = (time >> 8) & 0x7F;
+    if (snooze.count < SNOOZE_MAX_COUNT) { ++snooze.count; }
+    snooze.pending = 1;
+}
+
+/*
+ * Dismiss the alarm, snoozed or not. Alarm 2 is left to match once a
+ * day; its flag is only looked at while a snooze is pending.
+ */
+void snooze_cancel(void) {
+    snooze.pending = 0;
+    snooze.count = 0;
+}
+
+int snooze_pending(void) {
+    return snooze.pending;
+}
+
+int snooze_count(void) {
+    return snooze.count;
+}
+
+unsigned int snooze_wake_time(void) {
+    return snooze.wake_time;
+}
+
+/*
+ * Check for the end of a snooze, given the latest time word.
+ * Returns 1 once, when alarm 2 has gone off.
+ * The status register is read once per minute, one second after the
+ * minute starts, so that it can't race the flag being set.
+ */
+int snooze_task(unsigned int time) {
+    if (!snooze.pending) { return 0; }
+    unsigned char minute = (time >> 8) & 0x7F;
+    if (minute == snooze.checked_minute || !(time & 0x7F)) {
+        return 0;
+    }
+    snooze.checked_minute = minute;
+    if (!ds3231_cache_alarm_2_fired()) { return 0; }
+    snooze.pending = 0;
+    return 1;
+}
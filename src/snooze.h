@@ -0,0 +1,35 @@
+#ifndef _VVC_SNOOZE_H
+#define _VVC_SNOOZE_H
+
+#include "global.h"
+#include "ds3231_cache.h"
+#include "bcd.h"
+
+// Snooze. Up/Down while the alarm sounds puts it off for
+// 'alarm_snooze_min' minutes, by setting the DS3231's alarm 2 to the
+// current time plus that many minutes (a BCD add; no division). The
+// DS3231 does the comparing: its A2F flag latches when the hours and
+// minutes match, even while SQW runs the 1Hz output. So the MCU never
+// compares times for a snooze; it reads the status register once a
+// minute while one is pending, and can sleep in between.
+// (Alarm 2 has no seconds register; it matches at hh:mm:00.)
+#define SNOOZE_DEFAULT_MIN   9
+#define SNOOZE_MAX_COUNT     99
+
+typedef struct {
+    unsigned char pending;
+    unsigned char count;
+    // (0x0000hhmm, BCD)
+    unsigned short wake_time;
+    // Minute (BCD) whose alarm 2 flag has been checked already.
+    unsigned char checked_minute;
+} snooze_t;
+
+void snooze_start(unsigned int time);
+void snooze_cancel(void);
+int snooze_pending(void);
+int snooze_count(void);
+unsigned int snooze_wake_time(void);
+int snooze_task(unsigned int time);
+
+#endif
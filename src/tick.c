@@ -0,0 +1,35 @@
+#include "tick.h"
+#include "seven_seg_anim.h"
+#include "buzzer.h"
+#include "tone.h"
+#include "input.h"
+
+// Milliseconds since 'tick_init'. (Wraps every ~49 days.)
+static volatile unsigned int tick_count;
+
+/*
+ * Start the 1KHz SysTick interrupt.
+ */
+void tick_init(void) {
+    tick_count = 0;
+    SysTick_Config(TICK_RELOAD);
+}
+
+/*
+ * Get the millisecond tick count.
+ */
+unsigned int tick_ms(void) {
+    return tick_count;
+}
+
+/*
+ * SysTick interrupt: advance the tick, and run the periodic work which
+ * has to stay smooth no matter what the main loop is waiting on.
+ */
+void SysTick_handler(void) {
+    ++tick_count;
+    seven_seg_anim_tick();
+    buzzer_tick();
+    tone_tick();
+    input_tick();
+}
@@ -0,0 +1,16 @@
+#ifndef _VVC_TICK_H
+#define _VVC_TICK_H
+
+#include "global.h"
+
+// 1KHz system tick on the core's SysTick timer.
+// (48MHz / 48000; SysTick runs at the lowest interrupt priority, so
+//  it never delays the timebase or DMA interrupts.)
+#define TICK_HZ                 1000
+#define TICK_RELOAD             (48000000 / TICK_HZ)
+
+void tick_init(void);
+unsigned int tick_ms(void);
+void SysTick_handler(void);
+
+#endif
@@ -0,0 +1,63 @@
+#include "timebase.h"
+#include "rtc_stats.h"
+
+// Upper 16 bits of the microsecond count, pre-shifted.
+static volatile unsigned int timebase_hi;
+
+/*
+ * Start TIM14 as a free-running 1MHz counter.
+ * (48MHz PCLK / (47+1) = 1MHz)
+ */
+void timebase_init(void) {
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM14, ENABLE);
+    timebase_hi = 0;
+    TIMEBASE_TIM->CR1  = 0;
+    TIMEBASE_TIM->PSC  = TIMEBASE_PRESCALER;
+    TIMEBASE_TIM->ARR  = 0xFFFF;
+    TIMEBASE_TIM->CNT  = 0;
+    // Load the prescaler, then clear the update flag that it sets.
+    TIMEBASE_TIM->EGR  = TIM_EGR_UG;
+    TIMEBASE_TIM->SR   = 0;
+    TIMEBASE_TIM->DIER = TIM_DIER_UIE;
+    NVIC_EnableIRQ(TIMEBASE_IRQn);
+    TIMEBASE_TIM->CR1  = TIM_CR1_CEN;
+}
+
+/*
+ * Get the current 32-bit microsecond count.
+ * This is safe to call from interrupts which might be blocking the
+ * TIM14 interrupt; a pending overflow is accounted for here.
+ */
+unsigned int timebase_us(void) {
+    unsigned int primask = __get_PRIMASK();
+    __disable_irq();
+    unsigned int hi = timebase_hi;
+    unsigned int lo = TIMEBASE_TIM->CNT;
+    if ((TIMEBASE_TIM->SR & TIM_SR_UIF) && lo < 0x8000) {
+        hi += 0x00010000;
+    }
+    __set_PRIMASK(primask);
+    return hi | lo;
+}
+
+/*
+ * TIM14 interrupt: extend the counter on overflow, and timestamp
+ * DS3231 SQW edges captured on channel 1.
+ */
+void TIM14_IRQ_handler(void) {
+    unsigned int sr = TIMEBASE_TIM->SR;
+    if (sr & TIM_SR_CC1IF) {
+        // (Reading the capture register clears its flag.)
+        unsigned int lo = TIMEBASE_TIM->CCR1;
+        unsigned int hi = timebase_hi;
+        // A capture just after an overflow which is still pending.
+        if ((sr & TIM_SR_UIF) && lo < 0x8000) {
+            hi += 0x00010000;
+        }
+        rtc_stats_edge(hi | lo);
+    }
+    if (sr & TIM_SR_UIF) {
+        TIMEBASE_TIM->SR = ~TIM_SR_UIF;
+        timebase_hi += 0x00010000;
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef _VVC_TIMEBASE_H
+#define _VVC_TIMEBASE_H
+
+#include "global.h"
+
+// Free-running 1MHz timebase on TIM14.
+// (16-bit counter, extended to 32 bits in the update interrupt.
+//  The 32-bit count wraps every ~71 minutes.)
+// Channel 1 captures the DS3231's 1Hz output; see rtc_stats.h.
+#define TIMEBASE_TIM            TIM14
+#define TIMEBASE_IRQn           TIM14_IRQn
+#define TIMEBASE_PRESCALER      47
+
+void timebase_init(void);
+unsigned int timebase_us(void);
+void TIM14_IRQ_handler(void);
+
+#endif
@@ -0,0 +1,207 @@
+#include "tone.h"
+
+static void tone_next(void);
+static void tone_set_period(unsigned int period);
+
+// Timer periods for each note index, C5 to F#7.
+static const unsigned short tone_periods[TONE_NUM_NOTES] = {
+    BUZZER_PERIOD(523),  BUZZER_PERIOD(554),  BUZZER_PERIOD(587),
+    BUZZER_PERIOD(622),  BUZZER_PERIOD(659),  BUZZER_PERIOD(698),
+    BUZZER_PERIOD(740),  BUZZER_PERIOD(784),  BUZZER_PERIOD(831),
+    BUZZER_PERIOD(880),  BUZZER_PERIOD(932),  BUZZER_PERIOD(988),
+    BUZZER_PERIOD(1047), BUZZER_PERIOD(1109), BUZZER_PERIOD(1175),
+    BUZZER_PERIOD(1245), BUZZER_PERIOD(1319), BUZZER_PERIOD(1397),
+    BUZZER_PERIOD(1480), BUZZER_PERIOD(1568), BUZZER_PERIOD(1661),
+    BUZZER_PERIOD(1760), BUZZER_PERIOD(1865), BUZZER_PERIOD(1976),
+    BUZZER_PERIOD(2093), BUZZER_PERIOD(2217), BUZZER_PERIOD(2349),
+    BUZZER_PERIOD(2489), BUZZER_PERIOD(2637), BUZZER_PERIOD(2794),
+    BUZZER_PERIOD(2960)
+};
+// Sixteenth notes per duration code.
+static const unsigned char tone_units[7] = { 1, 2, 3, 4, 6, 8, 16 };
+
+// Built-in melodies.
+// (The old alarm: bursts of beeps.)
+static const unsigned char tone_beeps[] = {
+    50,
+    TONE_MARK,
+    TONE_N(TONE_C, 7, TONE_D8), TONE_R(TONE_D8),
+    TONE_REPEAT(3),
+    TONE_R(TONE_D1),
+    TONE_END
+};
+static const unsigned char tone_chirp[] = {
+    30,
+    TONE_MARK,
+    TONE_N(TONE_E, 6, TONE_D16), TONE_N(TONE_G, 6, TONE_D16),
+    TONE_N(TONE_C, 7, TONE_D16), TONE_N(TONE_E, 7, TONE_D16),
+    TONE_R(TONE_D4),
+    TONE_REPEAT(1),
+    TONE_R(TONE_D1), TONE_R(TONE_D1),
+    TONE_END
+};
+// (Westminster Quarters, an octave up.)
+static const unsigned char tone_chimes[] = {
+    100,
+    TONE_N(TONE_GS, 6, TONE_D4), TONE_N(TONE_FS, 6, TONE_D4),
+    TONE_N(TONE_E, 6, TONE_D4),  TONE_N(TONE_B, 5, TONE_D2),
+    TONE_N(TONE_E, 6, TONE_D4),  TONE_N(TONE_GS, 6, TONE_D4),
+    TONE_N(TONE_FS, 6, TONE_D4), TONE_N(TONE_B, 5, TONE_D2),
+    TONE_R(TONE_D1),
+    TONE_END
+};
+// (Fur Elise.)
+static const unsigned char tone_elise[] = {
+    75,
+    TONE_N(TONE_E, 6, TONE_D8),  TONE_N(TONE_DS, 6, TONE_D8),
+    TONE_N(TONE_E, 6, TONE_D8),  TONE_N(TONE_DS, 6, TONE_D8),
+    TONE_N(TONE_E, 6, TONE_D8),  TONE_N(TONE_B, 5, TONE_D8),
+    TONE_N(TONE_D, 6, TONE_D8),  TONE_N(TONE_C, 6, TONE_D8),
+    TONE_N(TONE_A, 5, TONE_D4DOT),
+    TONE_N(TONE_C, 5, TONE_D8),  TONE_N(TONE_E, 5, TONE_D8),
+    TONE_N(TONE_A, 5, TONE_D8),  TONE_N(TONE_B, 5, TONE_D4DOT),
+    TONE_R(TONE_D1),
+    TONE_END
+};
+// (Reveille's opening.)
+static const unsigned char tone_bugle[] = {
+    80,
+    TONE_MARK,
+    TONE_N(TONE_G, 5, TONE_D8),  TONE_N(TONE_C, 6, TONE_D16),
+    TONE_N(TONE_E, 6, TONE_D16), TONE_N(TONE_C, 6, TONE_D8),
+    TONE_N(TONE_E, 6, TONE_D8),
+    TONE_REPEAT(1),
+    TONE_N(TONE_G, 6, TONE_D4),  TONE_N(TONE_E, 6, TONE_D8),
+    TONE_N(TONE_C, 6, TONE_D8),  TONE_N(TONE_G, 5, TONE_D2),
+    TONE_R(TONE_D1),
+    TONE_END
+};
+
+static const tone_melody_t tone_melodies[] = {
+    { "Beeps",  tone_beeps },
+    { "Chirp",  tone_chirp },
+    { "Chimes", tone_chimes },
+    { "Elise",  tone_elise },
+    { "Bugle",  tone_bugle },
+#ifdef VVC_AUDIO
+    { "Birds",  0, &audio_clip_birds },
+#endif
+};
+#define TONE_NUM_MELODIES (sizeof(tone_melodies) / sizeof(tone_melodies[0]))
+
+static volatile tone_seq_t tone_seq;
+
+int tone_count(void) {
+    return TONE_NUM_MELODIES;
+}
+
+const char* tone_name(int melody) {
+    return tone_melodies[melody].name;
+}
+
+/*
+ * Start playing a melody, once or over and over. This only sets up
+ * the sequencer; the first note starts on the next tick.
+ */
+void tone_play(int melody, int loop) {
+    tone_stop();
+    if (melody < 0 || melody >= (int)TONE_NUM_MELODIES) { return; }
+#ifdef VVC_AUDIO
+    if (tone_melodies[melody].clip) {
+        audio_play_clip(tone_melodies[melody].clip, loop);
+        return;
+    }
+    audio_play_wave();
+#endif
+    const unsigned char* notes = tone_melodies[melody].notes;
+    tone_seq.unit_ms = notes[0];
+    tone_seq.start = &notes[1];
+    tone_seq.pos = tone_seq.start;
+    tone_seq.mark = tone_seq.start;
+    tone_seq.repeats = 0;
+    tone_seq.loop = loop;
+    tone_seq.note_ms = 1;
+    tone_seq.playing = 1;
+}
+
+void tone_stop(void) {
+    tone_seq.playing = 0;
+    tone_set_period(0);
+#ifdef VVC_AUDIO
+    audio_stop();
+#endif
+}
+
+int tone_playing(void) {
+#ifdef VVC_AUDIO
+    // (Clips play without the sequencer.)
+    return tone_seq.playing || audio_playing();
+#else
+    return tone_seq.playing;
+#endif
+}
+
+/*
+ * Step the sequencer. Called from the 1KHz tick.
+ */
+void tone_tick(void) {
+    if (!tone_seq.playing) { return; }
+    --tone_seq.note_ms;
+    if (tone_seq.note_ms == TONE_GAP_MS) {
+        tone_set_period(0);
+    }
+    else if (!tone_seq.note_ms) {
+        tone_next();
+    }
+}
+
+/*
+ * Start the next note or rest, handling any control bytes first.
+ */
+static void tone_next(void) {
+    int controls = 0;
+    unsigned char ev = *tone_seq.pos++;
+    while ((ev & TONE_CONTROL) == TONE_CONTROL) {
+        if (ev == TONE_END) {
+            if (!tone_seq.loop) {
+                tone_stop();
+                return;
+            }
+            tone_seq.pos = tone_seq.start;
+            tone_seq.repeats = 0;
+        }
+        else if (ev == TONE_MARK) {
+            tone_seq.mark = tone_seq.pos;
+        }
+        else if (!tone_seq.repeats) {
+            tone_seq.repeats = ev & ~TONE_CONTROL;
+            tone_seq.pos = tone_seq.mark;
+        }
+        else if (--tone_seq.repeats) {
+            tone_seq.pos = tone_seq.mark;
+        }
+        if (++controls > TONE_MAX_CONTROL) {
+            tone_stop();
+            return;
+        }
+        ev = *tone_seq.pos++;
+    }
+    tone_seq.note_ms = tone_units[ev >> 5] * tone_seq.unit_ms;
+    if ((ev & TONE_REST) == TONE_REST) {
+        tone_set_period(0);
+    }
+    else {
+        tone_set_period(tone_periods[ev & TONE_REST]);
+    }
+}
+
+/*
+ * Retune whichever voice is playing. (0 = silence)
+ */
+static void tone_set_period(unsigned int period) {
+#ifdef VVC_AUDIO
+    audio_wave_period(period);
+#else
+    buzzer_set_period(period);
+#endif
+}
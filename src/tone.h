@@ -0,0 +1,84 @@
+#ifndef _VVC_TONE_H
+#define _VVC_TONE_H
+
+#include "global.h"
+#include "buzzer.h"
+#include "audio.h"
+
+// Alarm tone sequencer. Melodies are byte strings in flash; the 1KHz
+// tick steps through them and retunes the buzzer for every note, so
+// playback never involves the main loop. (See tick.h)
+// In 'make AUDIO=1' builds, notes play on the wavetable voice instead
+// of the square wave, and sampled clips can be picked too. (audio.h)
+//
+// Melody format: one 'ms per sixteenth note' byte, then one byte
+// per event, ending with TONE_END:
+//   [7:5] duration code (TONE_D*), [4:0] note index or TONE_REST.
+// Duration code 7 marks control bytes:
+//   TONE_MARK      - start of a repeated section.
+//   TONE_REPEAT(n) - go back to the mark n more times. (No nesting.)
+//   TONE_END       - end. (Looping playback starts over.)
+#define TONE_NUM_NOTES      31
+#define TONE_REST           0x1F
+#define TONE_CONTROL        0xE0
+#define TONE_MARK           0xE0
+#define TONE_REPEAT(n)      (0xE0 | (n))
+#define TONE_END            0xFF
+// Duration codes, in sixteenth notes: 1, 2, 3, 4, 6, 8, 16.
+#define TONE_D16            0
+#define TONE_D8             1
+#define TONE_D8DOT          2
+#define TONE_D4             3
+#define TONE_D4DOT          4
+#define TONE_D2             5
+#define TONE_D1             6
+// Notes: semitones up from C5 (523Hz), up to F#7.
+#define TONE_C              0
+#define TONE_CS             1
+#define TONE_D              2
+#define TONE_DS             3
+#define TONE_E              4
+#define TONE_F              5
+#define TONE_FS             6
+#define TONE_G              7
+#define TONE_GS             8
+#define TONE_A              9
+#define TONE_AS             10
+#define TONE_B              11
+#define TONE_N(note, oct, dur)  (((dur) << 5) | ((note) + ((oct) - 5) * 12))
+#define TONE_R(dur)             (((dur) << 5) | TONE_REST)
+// Silence at the end of every note, so repeated notes don't run
+// together.
+#define TONE_GAP_MS         15
+// Guard against melodies which are nothing but control bytes.
+#define TONE_MAX_CONTROL    4
+
+typedef struct {
+    // Menu label. (Small OLED font)
+    const char* name;
+    const unsigned char* notes;
+#ifdef VVC_AUDIO
+    // Sampled clip to play instead of notes, if any.
+    const audio_clip_t* clip;
+#endif
+} tone_melody_t;
+
+typedef struct {
+    const unsigned char* start;
+    const unsigned char* pos;
+    const unsigned char* mark;
+    unsigned char  unit_ms;
+    unsigned char  repeats;
+    unsigned char  loop;
+    unsigned char  playing;
+    unsigned short note_ms;
+} tone_seq_t;
+
+int tone_count(void);
+const char* tone_name(int melody);
+void tone_play(int melody, int loop);
+void tone_stop(void);
+int tone_playing(void);
+void tone_tick(void);
+
+#endif
@@ -130,167 +130,132 @@ void oled_draw_rect(int x, int y, int w, int h,
     }
 }
 
+/*
+ * Small font: 5px-wide column bitmaps, LSB at the top. Most glyphs are
+ * 8px tall; 'g' and 'p' hang 2px lower, so columns are 16 bits.
+ * Only characters that are...well, used, are in it.
+ */
+static const char oled_small_chars[] =
+    "-./0123456789:>ABCDEMNOSTabcdefghilmnoprstuvxyz";
+static const unsigned short oled_small_glyphs[][5] = {
+    { 0x00, 0x10, 0x10, 0x10, 0x00 },  // '-'
+    { 0x00, 0xC0, 0xC0, 0x00, 0x00 },  // '.'
+    { 0x00, 0x60, 0x18, 0x06, 0x00 },  // '/'
+    { 0x7C, 0xA2, 0x92, 0x8A, 0x7C },  // '0'
+    { 0x00, 0x84, 0xFE, 0x80, 0x00 },  // '1'
+    { 0x84, 0xC2, 0xA2, 0x92, 0x8C },  // '2'
+    { 0x42, 0x82, 0x8A, 0x96, 0x62 },  // '3'
+    { 0x30, 0x28, 0x24, 0xFE, 0x20 },  // '4'
+    { 0x4E, 0x8A, 0x8A, 0x8A, 0x72 },  // '5'
+    { 0x78, 0x94, 0x92, 0x92, 0x60 },  // '6'
+    { 0x02, 0xE2, 0x12, 0x0A, 0x06 },  // '7'
+    { 0x6C, 0x92, 0x92, 0x92, 0x6C },  // '8'
+    { 0x0C, 0x92, 0x92, 0x52, 0x3C },  // '9'
+    { 0x00, 0x00, 0x24, 0x00, 0x00 },  // ':'
+    { 0x00, 0x22, 0x14, 0x08, 0x00 },  // '>'
+    { 0xF8, 0x16, 0x11, 0x16, 0xF8 },  // 'A'
+    { 0xFF, 0x91, 0x91, 0x91, 0x6E },  // 'B'
+    { 0x7E, 0x81, 0x81, 0x81, 0x42 },  // 'C'
+    { 0xFF, 0x81, 0x81, 0x81, 0x7E },  // 'D'
+    { 0xFF, 0x91, 0x91, 0x91, 0x81 },  // 'E'
+    { 0xFF, 0x02, 0x0C, 0x02, 0xFF },  // 'M'
+    { 0xFF, 0x04, 0x18, 0x20, 0xFF },  // 'N'
+    { 0x7E, 0x81, 0x81, 0x81, 0x7E },  // 'O'
+    { 0x66, 0x89, 0x99, 0x91, 0x66 },  // 'S'
+    { 0x01, 0x01, 0xFF, 0x01, 0x01 },  // 'T'
+    { 0x60, 0x94, 0x94, 0x94, 0x78 },  // 'a'
+    { 0xFF, 0x88, 0x88, 0x88, 0x70 },  // 'b'
+    { 0x70, 0x88, 0x88, 0x88, 0x00 },  // 'c'
+    { 0x70, 0x88, 0x88, 0x88, 0xFF },  // 'd'
+    { 0x7C, 0x92, 0x92, 0x92, 0x5C },  // 'e'
+    { 0x10, 0xFE, 0x11, 0x11, 0x06 },  // 'f'
+    { 0x0230, 0x0248, 0x0248, 0x0248, 0x01F8 },  // 'g'
+    { 0xFF, 0x08, 0x08, 0xF0, 0x00 },  // 'h'
+    { 0x00, 0x00, 0xFA, 0x00, 0x00 },  // 'i'
+    { 0x00, 0x00, 0xFF, 0x00, 0x00 },  // 'l'
+    { 0xFC, 0x08, 0xF8, 0x08, 0xF8 },  // 'm'
+    { 0xFC, 0x08, 0x08, 0xF0, 0x00 },  // 'n'
+    { 0x70, 0x88, 0x88, 0x88, 0x70 },  // 'o'
+    { 0x03F8, 0x0088, 0x0088, 0x0088, 0x0070 },  // 'p'
+    { 0x00, 0xFC, 0x08, 0x08, 0x10 },  // 'r'
+    { 0x00, 0x4C, 0x92, 0x92, 0x64 },  // 's'
+    { 0x04, 0x7F, 0x84, 0x84, 0x40 },  // 't'
+    { 0x3C, 0x40, 0x40, 0x7C, 0xC0 },  // 'u'
+    { 0x38, 0x40, 0x80, 0x40, 0x38 },  // 'v'
+    { 0x88, 0x50, 0x20, 0x50, 0x88 },  // 'x'
+    { 0x4C, 0x90, 0x90, 0x7C, 0x00 },  // 'y'
+    { 0x88, 0xC8, 0xA8, 0x98, 0x88 },  // 'z'
+};
+
+/*
+ * Large font: 9px-wide, 13px-tall column bitmaps, LSB at the top.
+ * Again, only the subset of letters needed.
+ */
+static const char oled_big_chars[] = "!:?ADEILMNORSTUVY";
+static const unsigned short oled_big_glyphs[][9] = {
+    // '!'
+    { 0x0000, 0x0000, 0x0000, 0x0000, 0x19FF, 0x19FF, 0x0000, 0x0000, 0x0000 },
+    // ':'
+    { 0x071C, 0x071C, 0x071C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+    // '?'
+    { 0x0000, 0x0003, 0x0003, 0x1BC3, 0x1BE3, 0x0073, 0x003F, 0x001E, 0x0000 },
+    // 'A'
+    { 0x1800, 0x1F00, 0x07F0, 0x03FF, 0x030F, 0x03FF, 0x07F0, 0x1F00, 0x1800 },
+    // 'D'
+    { 0x1FFF, 0x1FFF, 0x1803, 0x1803, 0x1803, 0x1C07, 0x0E0E, 0x07FC, 0x03F8 },
+    // 'E'
+    { 0x1FFF, 0x1FFF, 0x1863, 0x1863, 0x1863, 0x1863, 0x1863, 0x1863, 0x1863 },
+    // 'I'
+    { 0x1803, 0x1803, 0x1803, 0x1FFF, 0x1FFF, 0x1803, 0x1803, 0x1803, 0x0000 },
+    // 'L'
+    { 0x1FFF, 0x1FFF, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+    // 'M'
+    { 0x1FFF, 0x1FFF, 0x000F, 0x0078, 0x00E0, 0x0078, 0x000F, 0x1FFF, 0x1FFF },
+    // 'N'
+    { 0x1FFF, 0x1FFF, 0x0007, 0x003C, 0x00E0, 0x0780, 0x1C00, 0x1FFF, 0x1FFF },
+    // 'O'
+    { 0x03F8, 0x0FFE, 0x1C07, 0x1803, 0x1803, 0x1803, 0x1C07, 0x0FFE, 0x03F8 },
+    // 'R'
+    { 0x1FFF, 0x1FFF, 0x00C3, 0x00C3, 0x00C3, 0x00C3, 0x03E7, 0x1F7E, 0x1E3C },
+    // 'S'
+    { 0x181C, 0x183E, 0x1877, 0x1863, 0x1863, 0x1863, 0x1CE3, 0x0FC3, 0x0780 },
+    // 'T'
+    { 0x0003, 0x0003, 0x0003, 0x0003, 0x1FFF, 0x1FFF, 0x0003, 0x0003, 0x0003 },
+    // 'U'
+    { 0x07FF, 0x0FFF, 0x1C00, 0x1800, 0x1800, 0x1800, 0x1C00, 0x0FFF, 0x07FF },
+    // 'V'
+    { 0x003F, 0x00FF, 0x07E0, 0x1F00, 0x1C00, 0x1F00, 0x07E0, 0x00FF, 0x003F },
+    // 'Y'
+    { 0x0007, 0x000F, 0x003C, 0x1FF0, 0x1FF0, 0x003C, 0x000F, 0x0007, 0x0000 },
+};
+
+/*
+ * Draw a glyph's column bitmaps. Set pixels are drawn in 'color', and
+ * the rest are left alone.
+ */
+static void oled_draw_glyph(int x, int y, const unsigned short* cols,
+                            int w, unsigned char color) {
+    int col, row;
+    for (col = 0; col < w; ++col) {
+        unsigned int bits = cols[col];
+        for (row = 0; bits; ++row, bits >>= 1) {
+            if (bits & 1) { oled_write_pixel(x+col, y+row, color); }
+        }
+    }
+}
+
 /*
  * Draw a small letter. Each one is 5px wide (+1px for a space) and 8px
- * tall. So if y%8==0 they can easily fit in 1.5 words.
- * But for now, just write a series of lines and pixels for most letters.
- * Again, to save code space, only use letters that are...well, used.
+ * tall. Characters that aren't in the font are drawn as spaces.
+ * (These used to be drawn as series of lines and pixels, but the
+ *  bitmaps take a fraction of the code space.)
  */
 void oled_draw_small_letter(int x, int y, char c, unsigned char color) {
-    if (c == 'A') {
-        oled_draw_v_line(x, y+3, 5, 1);
-        oled_draw_v_line(x+4, y+3, 5, 1);
-        oled_draw_v_line(x+1, y+1, 2, 1);
-        oled_draw_v_line(x+3, y+1, 2, 1);
-        oled_write_pixel(x+2, y, 1);
-        oled_draw_h_line(x+1, y+4, 3, 1);
-    }
-    else if (c == 'D') {
-        oled_draw_v_line(x, y, 8, 1);
-        oled_draw_v_line(x+4, y+1, 6, 1);
-        oled_draw_h_line(x+1, y, 3, 1);
-        oled_draw_h_line(x+1, y+7, 3, 1);
-    }
-    else if (c == 'E') {
-        oled_draw_v_line(x, y, 8, 1);
-        oled_draw_h_line(x+1, y, 4, 1);
-        oled_draw_h_line(x+1, y+7, 4, 1);
-        oled_draw_h_line(x+1, y+4, 3, 1);
-    }
-    else if (c == 'M') {
-        oled_draw_v_line(x, y, 8, 1);
-        oled_draw_v_line(x+4, y, 8, 1);
-        oled_draw_v_line(x+2, y+2, 2, 1);
-        oled_write_pixel(x+1, y+1, 1);
-        oled_write_pixel(x+3, y+1, 1);
-    }
-    else if (c == 'O') {
-        oled_draw_v_line(x, y+1, 6, 1);
-        oled_draw_v_line(x+4, y+1, 6, 1);
-        oled_draw_h_line(x+1, y, 3, 1);
-        oled_draw_h_line(x+1, y+7, 3, 1);
-    }
-    else if (c == 'S') {
-        oled_draw_v_line(x, y+1, 2, 1);
-        oled_draw_v_line(x, y+5, 2, 1);
-        oled_draw_v_line(x+4, y+1, 2, 1);
-        oled_draw_v_line(x+4, y+5, 2, 1);
-        oled_draw_h_line(x+1, y, 3, 1);
-        oled_draw_h_line(x+1, y+7, 3, 1);
-        oled_draw_h_line(x+1, y+3, 2, 1);
-        oled_draw_h_line(x+2, y+4, 2, 1);
-    }
-    else if (c == 'T') {
-        oled_draw_h_line(x, y, 5, 1);
-        oled_draw_v_line(x+2, y, 8, 1);
-    }
-    else if (c == 'a') {
-        oled_draw_h_line(x+1, y+2, 3, 1);
-        oled_draw_h_line(x+1, y+4, 3, 1);
-        oled_draw_h_line(x+1, y+7, 3, 1);
-        oled_draw_v_line(x, y+5, 2, 1);
-        oled_draw_v_line(x+4, y+3, 4, 1);
-    }
-    else if (c == 'e') {
-        oled_draw_h_line(x+1, y+1, 3, 1);
-        oled_draw_h_line(x+1, y+4, 3, 1);
-        oled_draw_h_line(x+1, y+7, 3, 1);
-        oled_write_pixel(x+4, y+6, 1);
-        oled_draw_v_line(x, y+2, 5, 1);
-        oled_draw_v_line(x+4, y+2, 3, 1);
-    }
-    else if (c == 'f') {
-        oled_draw_h_line(x+2, y, 2, 1);
-        oled_draw_h_line(x, y+4, 4, 1);
-        oled_draw_v_line(x+1, y+1, 7, 1);
-        oled_draw_v_line(x+4, y+1, 2, 1);
-    }
-    else if (c == 'i') {
-        oled_write_pixel(x+2, y+1, 1);
-        oled_draw_v_line(x+2, y+3, 5, 1);
-    }
-    else if (c == 'l') {
-        oled_draw_v_line(x+2, y, 8, 1);
-    }
-    else if (c == 'm') {
-        oled_draw_h_line(x+1, y+3, 3, 1);
-        oled_draw_v_line(x, y+2, 6, 1);
-        oled_draw_v_line(x+2, y+3, 5, 1);
-        oled_draw_v_line(x+4, y+3, 5, 1);
-    }
-    else if (c == 'n') {
-        oled_draw_h_line(x+1, y+3, 2, 1);
-        oled_draw_v_line(x, y+2, 6, 1);
-        oled_draw_v_line(x+3, y+4, 4, 1);
-    }
-    else if (c == 'o') {
-        oled_draw_h_line(x+1, y+3, 3, 1);
-        oled_draw_h_line(x+1, y+7, 3, 1);
-        oled_draw_v_line(x, y+4, 3, 1);
-        oled_draw_v_line(x+4, y+4, 3, 1);
-    }
-    else if (c == 'r') {
-        oled_draw_h_line(x+2, y+3, 2, 1);
-        oled_write_pixel(x+4, y+4, 1);
-        oled_draw_v_line(x+1, y+2, 6, 1);
-    }
-    else if (c == 's') {
-        oled_draw_h_line(x+2, y+1, 2, 1);
-        oled_draw_h_line(x+2, y+4, 2, 1);
-        oled_draw_h_line(x+2, y+7, 2, 1);
-        oled_write_pixel(x+1, y+6, 1);
-        oled_write_pixel(x+4, y+2, 1);
-        oled_draw_v_line(x+1, y+2, 2, 1);
-        oled_draw_v_line(x+4, y+5, 2, 1);
-    }
-    else if (c == 't') {
-        oled_draw_h_line(x, y+2, 4, 1);
-        oled_draw_h_line(x+2, y+7, 2, 1);
-        oled_write_pixel(x+4, y+6, 1);
-        oled_draw_v_line(x+1, y, 7, 1);
-    }
-    else if (c == 'u') {
-        oled_draw_h_line(x+1, y+6, 4, 1);
-        oled_write_pixel(x+4, y+7, 1);
-        oled_draw_v_line(x, y+2, 4, 1);
-        oled_draw_v_line(x+3, y+2, 4, 1);
-    }
-    else if (c == 'x') {
-        oled_write_pixel(x, y+3, 1);
-        oled_write_pixel(x, y+7, 1);
-        oled_write_pixel(x+1, y+4, 1);
-        oled_write_pixel(x+1, y+6, 1);
-        oled_write_pixel(x+2, y+5, 1);
-        oled_write_pixel(x+3, y+4, 1);
-        oled_write_pixel(x+3, y+6, 1);
-        oled_write_pixel(x+4, y+3, 1);
-        oled_write_pixel(x+4, y+7, 1);
-    }
-    else if (c == 'y') {
-        oled_draw_h_line(x+1, y+4, 2, 1);
-        oled_draw_h_line(x+1, y+7, 2, 1);
-        oled_write_pixel(x, y+6, 1);
-        oled_draw_v_line(x, y+2, 2, 1);
-        oled_draw_v_line(x+3, y+2, 5, 1);
-    }
-    else if (c == ':') {
-        oled_write_pixel(x+2, y+2, 1);
-        oled_write_pixel(x+2, y+5, 1);
-    }
-    else if (c == '/') {
-        oled_draw_v_line(x+1, y+5, 2, 1);
-        oled_draw_v_line(x+2, y+3, 2, 1);
-        oled_draw_v_line(x+3, y+1, 2, 1);
-    }
-    else if (c == '>') {
-        oled_write_pixel(x+1, y+1, 1);
-        oled_write_pixel(x+2, y+2, 1);
-        oled_write_pixel(x+3, y+3, 1);
-        oled_write_pixel(x+2, y+4, 1);
-        oled_write_pixel(x+1, y+5, 1);
-    }
-    else if (c == ' ') {
-    }
+    const char* found = oled_small_chars;
+    while (*found && *found != c) { ++found; }
+    if (!*found) { return; }
+    oled_draw_glyph(x, y, oled_small_glyphs[found - oled_small_chars],
+                    5, color);
 }
 
 /*
@@ -308,128 +273,13 @@ void oled_draw_small_text(int x, int y, char* cc, unsigned char color) {
 
 /*
  * Draw a large letter. These are about 18px monospace.
- * I only added the subset of letters needed, to save code space.
  */
 void oled_draw_big_letter(int x, int y, char c, unsigned char color) {
-    if (c == 'A') {
-        oled_draw_rect(x, y+11, 2, 2, 0, color);
-        oled_draw_rect(x+7, y+11, 2, 2, 0, color);
-        oled_draw_rect(x+1, y+8, 2, 3, 0, color);
-        oled_draw_rect(x+1, y+8, 7, 2, 0, color);
-        oled_draw_rect(x+6, y+8, 2, 3, 0, color);
-        oled_draw_rect(x+2, y+4, 2, 4, 0, color);
-        oled_draw_rect(x+5, y+4, 2, 4, 0, color);
-        oled_draw_rect(x+3, y, 3, 4, 0, color);
-    }
-    else if (c == 'D') {
-        oled_draw_rect(x, y, 2, 13, 0, color);
-        oled_draw_rect(x+2, y, 4, 2, 0, color);
-        oled_draw_rect(x+2, y+11, 4, 2, 0, color);
-        oled_draw_rect(x+5, y+1, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+2, 2, 2, 0, color);
-        oled_draw_rect(x+7, y+3, 2, 7, 0, color);
-        oled_draw_rect(x+5, y+10, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+9, 2, 2, 0, color);
-    }
-    else if (c == 'E') {
-        oled_draw_rect(x, y, 2, 13, 0, color);
-        oled_draw_rect(x+2, y, 7, 2, 0, color);
-        oled_draw_rect(x+2, y+5, 7, 2, 0, color);
-        oled_draw_rect(x+2, y+11, 7, 2, 0, color);
-    }
-    else if (c == 'I') {
-        oled_draw_rect(x, y, 8, 2, 0, color);
-        oled_draw_rect(x+3, y+2, 2, 9, 0, color);
-        oled_draw_rect(x, y+11, 8, 2, 0, color);
-    }
-    else if (c == 'L') {
-        oled_draw_rect(x, y, 2, 13, 0, color);
-        oled_draw_rect(x+2, y+11, 7, 2, 0, color);
-    }
-    else if (c == 'M') {
-        oled_draw_rect(x, y, 2, 13, 0, color);
-        oled_draw_rect(x+2, y, 1, 4, 0, color);
-        oled_draw_rect(x+6, y, 1, 4, 0, color);
-        oled_draw_rect(x+3, y+3, 1, 4, 0, color);
-        oled_draw_rect(x+5, y+3, 1, 4, 0, color);
-        oled_draw_rect(x+4, y+5, 1, 3, 0, color);
-        oled_draw_rect(x+7, y, 2, 13, 0, color);
-    }
-    else if (c == 'N') {
-        oled_draw_rect(x, y, 2, 13, 0, color);
-        oled_draw_rect(x+7, y, 2, 13, 0, color);
-        oled_draw_v_line(x+2, y, 3, color);
-        oled_draw_v_line(x+3, y+2, 4, color);
-        oled_draw_v_line(x+4, y+5, 3, color);
-        oled_draw_v_line(x+5, y+7, 4, color);
-        oled_draw_v_line(x+6, y+10, 3, color);
-    }
-    else if (c == 'O') {
-        oled_draw_rect(x, y+3, 2, 7, 0, color);
-        oled_draw_rect(x+7, y+3, 2, 7, 0, color);
-        oled_draw_rect(x+2, y, 5, 2, 0, color);
-        oled_draw_rect(x+2, y+11, 5, 2, 0, color);
-        oled_draw_rect(x+1, y+1, 2, 2, 0, color);
-        oled_draw_rect(x+1, y+10, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+1, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+10, 2, 2, 0, color);
-    }
-    else if (c == 'R') {
-        oled_draw_rect(x, y, 2, 13, 0, color);
-        oled_draw_rect(x+2, y, 5, 2, 0, color);
-        oled_draw_rect(x+6, y+1, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+5, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+8, 2, 2, 0, color);
-        oled_draw_rect(x+2, y+6, 5, 2, 0, color);
-        oled_draw_rect(x+7, y+2, 2, 4, 0, color);
-        oled_draw_rect(x+7, y+9, 2, 4, 0, color);
-    }
-    else if (c == 'S') {
-        oled_draw_rect(x+2, y, 6, 2, 0, color);
-        oled_draw_rect(x+1, y+1, 2, 2, 0, color);
-        oled_draw_rect(x+1, y+4, 2, 2, 0, color);
-        oled_draw_rect(x, y+2, 2, 3, 0, color);
-        oled_draw_rect(x+2, y+5, 5, 2, 0, color);
-        oled_draw_rect(x+6, y+6, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+10, 2, 2, 0, color);
-        oled_draw_rect(x+7, y+7, 2, 4, 0, color);
-        oled_draw_rect(x, y+11, 7, 2, 0, color);
-    }
-    else if (c == 'T') {
-        oled_draw_rect(x, y, 9, 2, 0, color);
-        oled_draw_rect(x+4, y+2, 2, 11, 0, color);
-    }
-    else if (c == 'U') {
-        oled_draw_rect(x, y, 2, 11, 0, color);
-        oled_draw_rect(x+7, y, 2, 11, 0, color);
-        oled_draw_rect(x+1, y+10, 2, 2, 0, color);
-        oled_draw_rect(x+6, y+10, 2, 2, 0, color);
-        oled_draw_rect(x+2, y+11, 5, 2, 0, color);
-    }
-    else if (c == 'Y') {
-        oled_draw_rect(x, y, 2, 3, 0, color);
-        oled_draw_rect(x+6, y, 2, 3, 0, color);
-        oled_draw_rect(x+1, y+2, 2, 2, 0, color);
-        oled_draw_rect(x+5, y+2, 2, 2, 0, color);
-        oled_draw_rect(x+2, y+4, 4, 2, 0, color);
-        oled_draw_rect(x+3, y+6, 2, 7, 0, color);
-    }
-    else if (c == ':') {
-        oled_draw_rect(x, y+2, 3, 3, 0, color);
-        oled_draw_rect(x, y+8, 3, 3, 0, color);
-    }
-    else if (c == '?') {
-        oled_draw_rect(x+1, y, 6, 2, 0, color);
-        oled_draw_rect(x+6, y+1, 2, 4, 0, color);
-        oled_draw_rect(x+5, y+4, 2, 2, 0, color);
-        oled_draw_rect(x+4, y+5, 2, 2, 0, color);
-        oled_draw_rect(x+3, y+6, 2, 4, 0, color);
-        oled_draw_rect(x+3, y+11, 2, 2, 0, color);
-    }
-    else if (c == '!') {
-        oled_draw_rect(x+4, y, 2, 9, 0, color);
-        oled_draw_rect(x+4, y+11, 2, 2, 0, color);
-    }
+    const char* found = oled_big_chars;
+    while (*found && *found != c) { ++found; }
+    if (!*found) { return; }
+    oled_draw_glyph(x, y, oled_big_glyphs[found - oled_big_chars],
+                    9, color);
 }
 
 /*
@@ -445,6 +295,79 @@ void oled_draw_big_text(int x, int y, char* cc, unsigned char color) {
     }
 }
 
+/*
+ * Write a signed integer into a text buffer as decimal digits,
+ * zero-padded to at least 'min_digits' digits. Cortex-M0 has no divide
+ * instruction, so this subtracts powers of ten instead.
+ * Returns the number of characters written (not counting the '\0').
+ */
+int fmt_int(char* buf, int val, int min_digits) {
+    static const unsigned int pow10[10] = {
+        1000000000, 100000000, 10000000, 1000000, 100000,
+        10000, 1000, 100, 10, 1
+    };
+    int len = 0;
+    unsigned int uval = val;
+    if (val < 0) {
+        buf[len++] = '-';
+        uval = -val;
+    }
+    int i;
+    int started = 0;
+    for (i = 0; i < 10; ++i) {
+        char digit = '0';
+        while (uval >= pow10[i]) {
+            uval -= pow10[i];
+            ++digit;
+        }
+        if (digit != '0' || started || (10 - i) <= min_digits || i == 9) {
+            buf[len++] = digit;
+            started = 1;
+        }
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+/*
+ * Write an unsigned 24.8 fixed-point value with two decimal places.
+ * Returns the number of characters written (not counting the '\0').
+ */
+int fmt_q8(char* buf, unsigned int val_q8) {
+    int len = fmt_int(buf, val_q8 >> 8, 1);
+    buf[len++] = '.';
+    len += fmt_int(&buf[len], ((val_q8 & 0xFF) * 100) >> 8, 2);
+    return len;
+}
+
+/*
+ * Write a microsecond count as milliseconds with one decimal place,
+ * or none from 100ms up. (This divides; it's only for display rates.)
+ * Returns the number of characters written (not counting the '\0').
+ */
+int fmt_ms(char* buf, unsigned int us) {
+    unsigned int tenths = (us + 50) / 100;
+    int len = fmt_int(buf, tenths / 10, 1);
+    if (tenths >= 1000) { return len; }
+    buf[len++] = '.';
+    len += fmt_int(&buf[len], tenths % 10, 1);
+    return len;
+}
+
+/*
+ * Copy a string into a text buffer.
+ * Returns the number of characters written (not counting the '\0').
+ */
+int fmt_text(char* buf, const char* text) {
+    int len = 0;
+    while (text[len] != '\0') {
+        buf[len] = text[len];
+        ++len;
+    }
+    buf[len] = '\0';
+    return len;
+}
+
 /*
  * Process the default 'show time' clock state.
  */
@@ -452,34 +375,34 @@ void process_show_time_state() {
     // Draw the OLED GUI. Just print, "TIME:" in the center.
     char time_buffer[6] = { 'T', 'I', 'M', 'E', ':', '\0' };
     oled_draw_big_text(37, 26, time_buffer, 1);
+    // Draw the last temperature reading along the bottom.
+    char temp_buffer[10];
+    rtc_format_temperature(temp_buffer);
+    oled_draw_small_text(46, 50, temp_buffer, 1);
+    // And a pending snooze along the top, with when it ends.
+    if (snooze_pending()) {
+        char snooze_buffer[20];
+        unsigned int wake = snooze_wake_time();
+        int len = fmt_text(snooze_buffer, "Snooze ");
+        len += fmt_int(&snooze_buffer[len], snooze_count(), 0);
+        len += fmt_text(&snooze_buffer[len], " - ");
+        len += fmt_int(&snooze_buffer[len], BCD_TENS(wake >> 8), 1);
+        len += fmt_int(&snooze_buffer[len], BCD_ONES(wake >> 8), 1);
+        len += fmt_text(&snooze_buffer[len], ":");
+        len += fmt_int(&snooze_buffer[len], BCD_TENS(wake), 1);
+        fmt_int(&snooze_buffer[len], BCD_ONES(wake), 1);
+        oled_draw_small_text(16, 8, snooze_buffer, 1);
+    }
 
-    // Pull the current latch pin low.
-    GPIOA->ODR &= ~IOA_595_LATCH_PIN;
     // Write the current time to the 7-segment displays.
-    // Minutes 'ones'.
-    int cur_digit = (time_word & 0x00000F00) >> 8;
-    shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                        IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    // Minutes 'tens'.
-    cur_digit = (time_word & 0x0000F000) >> 12;
-    shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                        IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    // Hours 'ones'.
-    cur_digit = (time_word & 0x000F0000) >> 16;
-    shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                        IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    // 'Hours tens'.
-    cur_digit = (time_word & 0x00300000) >> 20;
-    shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                        IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    // Pull the latch pin high.
-    GPIOA->ODR |= IOA_595_LATCH_PIN;
+    seven_seg_set_time((time_word & 0x003F0000) >> 16,
+                       (time_word & 0x00007F00) >> 8);
+    seven_seg_set_blink(0);
 
     // Check input.
     // Up/Down buttons do nothing.
     // If Select button is pressed, switch to the 'menu page 1' state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         cur_state = VVC_STATE_MENU_PAGE_1;
     }
 }
@@ -492,53 +415,36 @@ void process_in_alarm_state() {
     char alarm_buffer[10] = { 'A', 'L', 'A', 'R', 'M',
                               '!', '!', '!', '!', '\0' };
     oled_draw_big_text(18, 26, alarm_buffer, 1);
-
-    // Pull the current latch pin low.
-    GPIOA->ODR &= ~IOA_595_LATCH_PIN;
-    int cur_digit = 0xFF;
-    if (time_word & 0x00000001) {
-        // Blank digits.
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        // Pull the latch pin high.
-        GPIOA->ODR |= IOA_595_LATCH_PIN;
-    }
-    else {
-        // Show digits, alarm.
-        // Minutes 'ones'.
-        cur_digit = (time_word & 0x00000F00) >> 8;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        // Minutes 'tens'.
-        cur_digit = (time_word & 0x0000F000) >> 12;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        // Hours 'ones'.
-        cur_digit = (time_word & 0x000F0000) >> 16;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        // 'Hours tens'.
-        cur_digit = (time_word & 0x00300000) >> 20;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        // Pull the latch pin high.
-        GPIOA->ODR |= IOA_595_LATCH_PIN;
-        pulse_out_pin(&GPIOA->ODR, IOA_BUZZER_PIN, 200, 500);
+    // Show how many times it has been snoozed already.
+    if (snooze_count()) {
+        char snooze_buffer[16];
+        int len = fmt_text(snooze_buffer, "Snoozed ");
+        len += fmt_int(&snooze_buffer[len], snooze_count(), 0);
+        fmt_text(&snooze_buffer[len], "x");
+        oled_draw_small_text(34, 48, snooze_buffer, 1);
     }
 
+    // Flash the time. (The alarm's melody is kept going by the sound
+    // task; see main.c)
+    seven_seg_set_time((time_word & 0x003F0000) >> 16,
+                       (time_word & 0x00007F00) >> 8);
+    seven_seg_set_blink(SEVEN_SEG_ALL_DIGITS);
+
     // Check input.
-    // Up/Down buttons do nothing.
-    // If Select button is pressed, switch to the 'show time' state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    // Up/Down buttons snooze the alarm; the DS3231's alarm 2 brings
+    // it back. (See snooze.h)
+    // Select dismisses it. Both switch to the 'show time' state.
+    if (input_frame.pressed) {
+        if (input_frame.pressed & IOA_BUTTON_SELECT) {
+            snooze_cancel();
+        }
+        else {
+            snooze_start(time_word);
+        }
         cur_state = VVC_STATE_SHOW_TIME;
         alarm_remember_off = 1;
+        tone_stop();
+        buzzer_ramp(0);
     }
 }
 
@@ -571,12 +477,10 @@ void process_menu_page_1_state() {
 
     // Check input.
     // Up/Down buttons change menu cursor position.
-    if (((~GPIOA->IDR) & IOA_BUTTON_UP) &&
-        !(last_button_state & IOA_BUTTON_UP)) {
+    if (input_frame.pressed & IOA_BUTTON_UP) {
         if (cursor_position > 0) { --cursor_position; }
     }
-    else if (((~GPIOA->IDR) & IOA_BUTTON_DOWN) &&
-             !(last_button_state & IOA_BUTTON_DOWN)) {
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
         if (cursor_position < 2) { ++cursor_position; }
         else {
             // Move to menu page 2, and set cursor position to 0.
@@ -585,42 +489,29 @@ void process_menu_page_1_state() {
         }
     }
     // If Select button is pressed, switch to the selected state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         if (cursor_position == 0) {
             cur_state = VVC_STATE_SET_TIME;
             // Set 'time_to_set' to the current time.
             time_to_set = time_word;
-            int hours_tens = (time_to_set & 0x00300000) >> 20;
-            int hours_ones = (time_to_set & 0x000F0000) >> 16;
-            cur_hours = (hours_tens * 10) + hours_ones;
-            int minutes_tens = (time_to_set & 0x0000F000) >> 12;
-            int minutes_ones = (time_to_set & 0x00000F00) >> 8;
-            cur_minutes = (minutes_tens * 10) + minutes_ones;
+            cur_hours = (time_to_set & 0x003F0000) >> 16;
+            cur_minutes = (time_to_set & 0x00007F00) >> 8;
         }
         else if (cursor_position == 1) {
             cur_state = VVC_STATE_SET_ALARM;
             cursor_position = 0;
             // Set the 'time_to_set' values to the current 'alarm 1'.
-            time_to_set = ds3231_get_alarm_1(I2C1_BASE);
-            int hours_tens = (time_to_set & 0x00003000) >> 12;
-            int hours_ones = (time_to_set & 0x00000F00) >> 8;
-            cur_hours = (hours_tens * 10) + hours_ones;
-            int minutes_tens = (time_to_set & 0x000000F0) >> 4;
-            int minutes_ones = (time_to_set & 0x0000000F);
-            cur_minutes = (minutes_tens * 10) + minutes_ones;
+            time_to_set = ds3231_cache_get_alarm_1();
+            cur_hours = (time_to_set & 0x00003F00) >> 8;
+            cur_minutes = (time_to_set & 0x0000007F);
         }
         else if (cursor_position == 2) {
             cur_state = VVC_STATE_SET_ALARM_DAYS;
             cursor_position = 0;
             // Set the 'time_to_set' values to the current 'alarm 1'.
-            time_to_set = ds3231_get_alarm_1(I2C1_BASE);
-            int hours_tens = (time_to_set & 0x00003000) >> 12;
-            int hours_ones = (time_to_set & 0x00000F00) >> 8;
-            cur_hours = (hours_tens * 10) + hours_ones;
-            int minutes_tens = (time_to_set & 0x000000F0) >> 4;
-            int minutes_ones = (time_to_set & 0x0000000F);
-            cur_minutes = (minutes_tens * 10) + minutes_ones;
+            time_to_set = ds3231_cache_get_alarm_1();
+            cur_hours = (time_to_set & 0x00003F00) >> 8;
+            cur_minutes = (time_to_set & 0x0000007F);
         }
         else {
             cur_state = VVC_STATE_SHOW_TIME; // (Shouldn't happen)
@@ -638,8 +529,9 @@ void process_menu_page_2_state() {
     char menu_buffer[5] = { 'M', 'E', 'N', 'U', '\0' };
     oled_draw_big_text(42, 4, menu_buffer, 1);
 
-    // Draw 3 menu lines:
-    // 'Set Alarm On/Off', 'Set Alarm Tone', 'Exit Menu'.
+    // Draw the menu lines:
+    // 'Set Alarm On/Off', 'Set Alarm Tone', and 'Diagnostics' in
+    // builds which have it.
     oled_draw_h_line(0, 18, 127, 1);
     char set_alarm_state_buffer[17] = { 'S', 'e', 't', ' ', 'A',
                                         'l', 'a', 'r', 'm', ' ',
@@ -652,18 +544,19 @@ void process_menu_page_2_state() {
                                      'T', 'o', 'n', 'e', '\0'};
     oled_draw_small_text(38, 32, set_alarm_tone_buffer, 1);
     oled_draw_h_line(0, 42, 127, 1);
-    char exit_menu_buffer[10] = { 'E', 'x', 'i', 't', ' ',
-                                'M', 'e', 'n', 'u', '\0' };
-    oled_draw_small_text(66, 44, exit_menu_buffer, 1);
+#ifdef VVC_DIAGNOSTICS
+    char diagnostics_buffer[12] = { 'D', 'i', 'a', 'g', 'n', 'o',
+                                    's', 't', 'i', 'c', 's', '\0' };
+    oled_draw_small_text(56, 44, diagnostics_buffer, 1);
     oled_draw_h_line(0, 54, 127, 1);
+#endif
 
     // Draw a chevron at the appropriate height.
     oled_draw_small_letter(12, 21+(cursor_position*12), '>', 1);
 
     // Check input.
     // Up/Down buttons change menu cursor position.
-    if (((~GPIOA->IDR) & IOA_BUTTON_UP) &&
-        !(last_button_state & IOA_BUTTON_UP)) {
+    if (input_frame.pressed & IOA_BUTTON_UP) {
         if (cursor_position > 0) { --cursor_position; }
         else {
             // Move to menu page 1, and set cursor position to 0.
@@ -671,40 +564,82 @@ void process_menu_page_2_state() {
             cursor_position = 0;
         }
     }
-    else if (((~GPIOA->IDR) & IOA_BUTTON_DOWN) &&
-             !(last_button_state & IOA_BUTTON_DOWN)) {
-        if (cursor_position < 2) { ++cursor_position; }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        if (cursor_position < MENU_PAGE_2_LAST) { ++cursor_position; }
+        else {
+            // Move to menu page 3, and set cursor position to 0.
+            cur_state = VVC_STATE_MENU_PAGE_3;
+            cursor_position = 0;
+        }
     }
     // If Select button is pressed, switch to the selected state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         if (cursor_position == 0) {
             cur_state = VVC_STATE_SET_ALARM_STATE;
             // Set the 'time_to_set' values to the current 'alarm 1'.
-            time_to_set = ds3231_get_alarm_1(I2C1_BASE);
-            int hours_tens = (time_to_set & 0x00003000) >> 12;
-            int hours_ones = (time_to_set & 0x00000F00) >> 8;
-            cur_hours = (hours_tens * 10) + hours_ones;
-            int minutes_tens = (time_to_set & 0x000000F0) >> 4;
-            int minutes_ones = (time_to_set & 0x0000000F);
-            cur_minutes = (minutes_tens * 10) + minutes_ones;
+            time_to_set = ds3231_cache_get_alarm_1();
+            cur_hours = (time_to_set & 0x00003F00) >> 8;
+            cur_minutes = (time_to_set & 0x0000007F);
         }
         else if (cursor_position == 1) {
             cur_state = VVC_STATE_SET_ALARM_TONE;
+            // Preview the current tone.
+            tone_play(alarm_tone, 0);
+        }
+#ifdef VVC_DIAGNOSTICS
+        else {
+            // (Covers 'Diagnostics' position 2)
+            cur_state = VVC_STATE_DIAGNOSTICS;
+        }
+#endif
+        // Also reset cursor position to 0.
+        cursor_position = 0;
+    }
+}
+
+/*
+ * Process the 'menu page 3' state.
+ */
+void process_menu_page_3_state() {
+    // Draw a large, 'MENU' along the top.
+    char menu_buffer[5] = { 'M', 'E', 'N', 'U', '\0' };
+    oled_draw_big_text(42, 4, menu_buffer, 1);
+
+    // Draw 2 menu lines: 'Brightness', 'Exit Menu'.
+    oled_draw_h_line(0, 18, 127, 1);
+    char brightness_buffer[11] = { 'B', 'r', 'i', 'g', 'h',
+                                   't', 'n', 'e', 's', 's', '\0' };
+    oled_draw_small_text(62, 20, brightness_buffer, 1);
+    oled_draw_h_line(0, 30, 127, 1);
+    char exit_menu_buffer[10] = { 'E', 'x', 'i', 't', ' ',
+                                'M', 'e', 'n', 'u', '\0' };
+    oled_draw_small_text(66, 32, exit_menu_buffer, 1);
+    oled_draw_h_line(0, 42, 127, 1);
+
+    // Draw a chevron at the appropriate height.
+    oled_draw_small_letter(12, 21+(cursor_position*12), '>', 1);
+
+    // Check input.
+    // Up button moves back to page 2.
+    if (input_frame.pressed & IOA_BUTTON_UP) {
+        if (cursor_position > 0) { --cursor_position; }
+        else {
+            // Move to menu page 2, and set cursor position to 0.
+            cur_state = VVC_STATE_MENU_PAGE_2;
             cursor_position = 0;
-            // Set the 'time_to_set' values to the current 'alarm 1'.
-            time_to_set = ds3231_get_alarm_1(I2C1_BASE);
-            int hours_tens = (time_to_set & 0x00003000) >> 12;
-            int hours_ones = (time_to_set & 0x00000F00) >> 8;
-            cur_hours = (hours_tens * 10) + hours_ones;
-            int minutes_tens = (time_to_set & 0x000000F0) >> 4;
-            int minutes_ones = (time_to_set & 0x0000000F);
-            cur_minutes = (minutes_tens * 10) + minutes_ones;
+        }
+    }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        if (cursor_position < 1) { ++cursor_position; }
+    }
+    // If Select button is pressed, switch to the selected state.
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
+        if (cursor_position == 0) {
+            cur_state = VVC_STATE_SET_BRIGHTNESS;
         }
         else {
-            // (Covers 'Exit menu' position 2)
+            // (Covers 'Exit menu' position 1)
             cur_state = VVC_STATE_SHOW_TIME;
-            cursor_position = 0;
         }
         // Also reset cursor position to 0.
         cursor_position = 0;
@@ -715,93 +650,108 @@ void process_menu_page_2_state() {
  * Process the 'set time' state.
  */
 void process_set_time_state() {
-    // Draw centered 'SET TIME:'
-    char set_time_buffer[10] = { 'S', 'E', 'T', ' ', 'T',
-                                 'I', 'M', 'E', ':', '\0' };
-    oled_draw_big_text(18, 26, set_time_buffer, 1);
-
-    // Draw the currently-chosen time to the 7-segment displays.
-    // Pull the current latch pin low.
-    GPIOA->ODR &= ~IOA_595_LATCH_PIN;
-    int cur_digit = 0xFF;
-    // Blank the digits being set every other (seconds%2)
-    // Minutes tens/ones.
-    if (cursor_position == 1 && (time_word & 0x00000001)) {
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
+    if (time_invalid) {
+        // Draw 'TIME INVALID' on two lines, with a prompt below.
+        char time_buffer[5] = { 'T', 'I', 'M', 'E', '\0' };
+        oled_draw_big_text(42, 8, time_buffer, 1);
+        char invalid_buffer[8] = { 'I', 'N', 'V', 'A', 'L',
+                                   'I', 'D', '\0' };
+        oled_draw_big_text(26, 26, invalid_buffer, 1);
+        char prompt_buffer[10] = { 'S', 'e', 't', ' ', 't',
+                                   'i', 'm', 'e', ':', '\0' };
+        oled_draw_small_text(37, 48, prompt_buffer, 1);
     }
     else {
-        cur_digit = cur_minutes % 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        cur_digit = cur_minutes / 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    }
-    // Hours tens/ones.
-    if (cursor_position == 0 && (time_word & 0x00000001)) {
-        cur_digit = 0xFF;
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
+        // Draw centered 'SET TIME:'
+        char set_time_buffer[10] = { 'S', 'E', 'T', ' ', 'T',
+                                     'I', 'M', 'E', ':', '\0' };
+        oled_draw_big_text(18, 26, set_time_buffer, 1);
+    }
+
+    // Draw the currently-chosen time to the 7-segment displays.
+    seven_seg_set_time(cur_hours, cur_minutes);
+    // Blink the digits being set.
+    if (cursor_position == 0) {
+        seven_seg_set_blink(SEVEN_SEG_HOURS_DIGITS);
     }
     else {
-        cur_digit = cur_hours % 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        cur_digit = cur_hours / 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
+        seven_seg_set_blink(SEVEN_SEG_MINUTES_DIGITS);
     }
-    // Pull the latch pin high.
-    GPIOA->ODR |= IOA_595_LATCH_PIN;
 
     // Check input.
     // Up/Down buttons move the current selection (hours or minutes).
-    if (((~GPIOA->IDR) & IOA_BUTTON_UP) &&
-        !(last_button_state & IOA_BUTTON_UP)) {
+    // (Held down, they repeat; minutes end up jumping by 10.)
+    if (input_frame.pressed & IOA_BUTTON_UP) {
         if (cursor_position == 0) {
-            ++cur_hours;
-            if (cur_hours >= 24) { cur_hours = 0; }
+            cur_hours = bcd_inc(cur_hours, BCD_WRAP_HOURS);
+        }
+        else if (input_frame.pressed & INPUT_FAST) {
+            cur_minutes = bcd_inc_tens(cur_minutes, BCD_WRAP_MINUTES);
         }
         else if (cursor_position == 1) {
-            ++cur_minutes;
-            if (cur_minutes >= 60) { cur_minutes = 0; }
+            cur_minutes = bcd_inc(cur_minutes, BCD_WRAP_MINUTES);
         }
+        // (Keep the field lit while it changes.)
+        seven_seg_anim_blink_restart();
     }
-    else if (((~GPIOA->IDR) & IOA_BUTTON_DOWN) &&
-             !(last_button_state & IOA_BUTTON_DOWN)) {
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
         if (cursor_position == 0) {
-            if (cur_hours == 0) { cur_hours = 23; }
-            else { --cur_hours; }
+            cur_hours = bcd_dec(cur_hours, BCD_WRAP_HOURS);
+        }
+        else if (input_frame.pressed & INPUT_FAST) {
+            cur_minutes = bcd_dec_tens(cur_minutes, BCD_WRAP_MINUTES);
         }
         else if (cursor_position == 1) {
-            if (cur_minutes == 0) { cur_minutes = 59; }
-            else { --cur_minutes; }
+            cur_minutes = bcd_dec(cur_minutes, BCD_WRAP_MINUTES);
         }
+        // (Keep the field lit while it changes.)
+        seven_seg_anim_blink_restart();
     }
     // If Select button is pressed, progress one step. Use cursor position
     // Step 0: Set 'hours'
     // Step 1: Set 'minutes'
     // Step 2: Set time and back to default 'show time' screen.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         if (cursor_position == 0) {
             cursor_position = 1;
         }
         else {
-            unsigned int hours_enc = cur_hours / 10;
-            hours_enc = hours_enc << 4;
-            hours_enc |= (cur_hours % 10);
-            unsigned int mins_enc = cur_minutes / 10;
-            mins_enc = mins_enc << 4;
-            mins_enc |= (cur_minutes % 10);
-            ds3231_set_time(I2C1_BASE, hours_enc, mins_enc);
+            // Record how far the clock was stepped, for diagnostics.
+            // (A garbage time after an oscillator stop says nothing.)
+            int step_s = 0;
+            if (!time_invalid) {
+                step_s = (int)rtc_time_to_sod((cur_hours << 16) |
+                                              (cur_minutes << 8)) -
+                         (int)rtc_time_to_sod(time_word & 0x00FFFFFF);
+                if (step_s > (RTC_SECONDS_PER_DAY / 2)) {
+                    step_s -= RTC_SECONDS_PER_DAY;
+                }
+                else if (step_s <= -(RTC_SECONDS_PER_DAY / 2)) {
+                    step_s += RTC_SECONDS_PER_DAY;
+                }
+            }
+            // (The editors already hold DS3231-format BCD.)
+            ds3231_cache_set_time(cur_hours, cur_minutes);
+            rtc_stats_note_resync(step_s);
+            if (time_invalid) {
+                // The user confirmed a time, so now the time is valid.
+                ds3231_cache_clear_osf();
+                time_invalid = 0;
+            }
             cur_state = VVC_STATE_SHOW_TIME;
             cursor_position = 0;
+            // Sweep the new time in over the old one. (The face still
+            // shows the editor, so the old one is drawn to be wiped
+            // away; and the RTC task won't read the new one back for
+            // up to a second, so it goes straight into 'time_word'.)
+            seven_seg_set_blink(0);
+            seven_seg_set_time((time_word & 0x003F0000) >> 16,
+                               (time_word & 0x00007F00) >> 8);
+            unsigned int old_face = seven_seg_compose(0);
+            time_word = (time_word & 0xFF000000) |
+                        (cur_hours << 16) | (cur_minutes << 8);
+            seven_seg_set_time(cur_hours, cur_minutes);
+            seven_seg_anim_wipe(old_face, SEVEN_SEG_ANIM_LEFT);
         }
     }
 }
@@ -817,88 +767,61 @@ void process_set_alarm_state() {
 
     // Draw the current hours/minutes.
     // Draw the currently-chosen time to the 7-segment displays.
-    // Pull the current latch pin low.
-    GPIOA->ODR &= ~IOA_595_LATCH_PIN;
-    int cur_digit = 0xFF;
-    // Blank the digits being set every other (seconds%2)
-    // Minutes tens/ones.
-    if (cursor_position == 1 && (time_word & 0x00000001)) {
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
+    seven_seg_set_time(cur_hours, cur_minutes);
+    // Blink the digits being set.
+    if (cursor_position == 0) {
+        seven_seg_set_blink(SEVEN_SEG_HOURS_DIGITS);
     }
     else {
-        cur_digit = cur_minutes % 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        cur_digit = cur_minutes / 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    }
-    // Hours tens/ones.
-    if (cursor_position == 0 && (time_word & 0x00000001)) {
-        cur_digit = 0xFF;
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        shift_byte_out(cur_digit, &GPIOA->ODR,
-                       IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
+        seven_seg_set_blink(SEVEN_SEG_MINUTES_DIGITS);
     }
-    else {
-        cur_digit = cur_hours % 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-        cur_digit = cur_hours / 10;
-        shift_7_segment_out(cur_digit, &GPIOA->ODR,
-                            IOA_595_CLOCK_PIN, IOA_595_DATA_PIN);
-    }
-    // Pull the latch pin high.
-    GPIOA->ODR |= IOA_595_LATCH_PIN;
 
     // Check input.
     // Up/Down buttons move the current selection (hours or minutes).
-    if (((~GPIOA->IDR) & IOA_BUTTON_UP) &&
-        !(last_button_state & IOA_BUTTON_UP)) {
+    // (Held down, they repeat; minutes end up jumping by 10.)
+    if (input_frame.pressed & IOA_BUTTON_UP) {
         if (cursor_position == 0) {
-            ++cur_hours;
-            if (cur_hours >= 24) { cur_hours = 0; }
+            cur_hours = bcd_inc(cur_hours, BCD_WRAP_HOURS);
+        }
+        else if (input_frame.pressed & INPUT_FAST) {
+            cur_minutes = bcd_inc_tens(cur_minutes, BCD_WRAP_MINUTES);
         }
         else if (cursor_position == 1) {
-            ++cur_minutes;
-            if (cur_minutes >= 60) { cur_minutes = 0; }
+            cur_minutes = bcd_inc(cur_minutes, BCD_WRAP_MINUTES);
         }
+        // (Keep the field lit while it changes.)
+        seven_seg_anim_blink_restart();
     }
-    else if (((~GPIOA->IDR) & IOA_BUTTON_DOWN) &&
-             !(last_button_state & IOA_BUTTON_DOWN)) {
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
         if (cursor_position == 0) {
-            if (cur_hours == 0) { cur_hours = 23; }
-            else { --cur_hours; }
+            cur_hours = bcd_dec(cur_hours, BCD_WRAP_HOURS);
+        }
+        else if (input_frame.pressed & INPUT_FAST) {
+            cur_minutes = bcd_dec_tens(cur_minutes, BCD_WRAP_MINUTES);
         }
         else if (cursor_position == 1) {
-            if (cur_minutes == 0) { cur_minutes = 59; }
-            else { --cur_minutes; }
+            cur_minutes = bcd_dec(cur_minutes, BCD_WRAP_MINUTES);
         }
+        // (Keep the field lit while it changes.)
+        seven_seg_anim_blink_restart();
     }
     // If Select button is pressed, progress one step. Use cursor position
     // Step 0: Set 'hours'
     // Step 1: Set 'minutes'
     // Step 2: Set time and back to default 'show time' screen.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         if (cursor_position == 0) {
             cursor_position = 1;
         }
         else {
-            unsigned int hours_enc = cur_hours / 10;
-            hours_enc = hours_enc << 4;
-            hours_enc |= (cur_hours % 10);
-            unsigned int mins_enc = cur_minutes / 10;
-            mins_enc = mins_enc << 4;
-            mins_enc |= (cur_minutes % 10);
-            ds3231_set_alarm_1_time(I2C1_BASE, hours_enc, mins_enc);
+            // (The editors already hold DS3231-format BCD.)
+            ds3231_cache_set_alarm_1_time(cur_hours, cur_minutes);
+            // (A new alarm time replaces any snooze of the old one.)
+            snooze_cancel();
             cur_state = VVC_STATE_SHOW_TIME;
             cursor_position = 0;
-            alarm_word = ds3231_get_alarm_1(I2C1_BASE);
+            // (Served from the register mirror; no read-back.)
+            alarm_word = ds3231_cache_get_alarm_1();
             alarm_word = alarm_word << 8;
         }
     }
@@ -916,27 +839,90 @@ void process_set_alarm_days_state() {
     // Check input.
     // Up/Down buttons do nothing.
     // If Select button is pressed, switch to the 'show time' state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         cur_state = VVC_STATE_SHOW_TIME;
     }
 }
 
 /*
- * Process the 'set alarm tone' state.
+ * Process the 'set alarm tone' state: the alarm's melody, and how
+ * long it takes to build up to full volume.
  */
 void process_set_alarm_tone_state() {
+    // Crescendo lengths to choose from, in seconds. (0 = off)
+    static const unsigned char ramp_options[5] = { 0, 15, 30, 60, 120 };
+    // Snooze lengths to choose from, in minutes.
+    static const unsigned char snooze_options[5] = { 5, 9, 10, 15, 20 };
+    char line[20];
+    int len;
+
     // Draw centered 'ALARM TONE:'
     char set_alarm_days_buffer[12] = { 'A', 'L', 'A', 'R', 'M', ' ',
                                        'T', 'O', 'N', 'E', ':', '\0' };
-    oled_draw_big_text(5, 16, set_alarm_days_buffer, 1);
+    oled_draw_big_text(5, 4, set_alarm_days_buffer, 1);
+    oled_draw_h_line(0, 26, 127, 1);
+
+    // Draw the 3 settings, and a chevron on the one being set.
+    len = fmt_text(line, "Tone       ");
+    fmt_text(&line[len], tone_name(alarm_tone));
+    oled_draw_small_text(16, 30, line, 1);
+    len = fmt_text(line, "Crescendo  ");
+    if (alarm_ramp_s) {
+        len += fmt_int(&line[len], alarm_ramp_s, 0);
+        fmt_text(&line[len], "s");
+    }
+    else {
+        fmt_text(&line[len], "Off");
+    }
+    oled_draw_small_text(16, 40, line, 1);
+    len = fmt_text(line, "Snooze     ");
+    len += fmt_int(&line[len], alarm_snooze_min, 0);
+    fmt_text(&line[len], "m");
+    oled_draw_small_text(16, 50, line, 1);
+    oled_draw_small_letter(6, 30+(cursor_position*10), '>', 1);
 
     // Check input.
-    // Up/Down buttons do nothing.
-    // If Select button is pressed, switch to the 'show time' state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
-        cur_state = VVC_STATE_SHOW_TIME;
+    // Up/Down buttons change the current setting. New tones play
+    // once as a preview.
+    int delta = 0;
+    if (input_frame.pressed & IOA_BUTTON_UP) {
+        delta = 1;
+    }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        delta = -1;
+    }
+    if (delta) {
+        if (cursor_position == 0) {
+            int tone = alarm_tone + delta;
+            if (tone < 0) { tone = tone_count() - 1; }
+            if (tone >= tone_count()) { tone = 0; }
+            alarm_tone = tone;
+            tone_play(alarm_tone, 0);
+        }
+        else if (cursor_position == 1) {
+            int i = 0;
+            while (i < 4 && ramp_options[i] != alarm_ramp_s) { ++i; }
+            i = (i + 5 + delta) % 5;
+            alarm_ramp_s = ramp_options[i];
+        }
+        else {
+            int i = 0;
+            while (i < 4 && snooze_options[i] != alarm_snooze_min) { ++i; }
+            i = (i + 5 + delta) % 5;
+            alarm_snooze_min = snooze_options[i];
+        }
+    }
+    // If Select button is pressed, move to the next setting; after
+    // the last one, switch to the 'show time' state.
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
+        if (cursor_position < 2) {
+            ++cursor_position;
+        }
+        else {
+            tone_stop();
+            cur_state = VVC_STATE_SHOW_TIME;
+            cursor_position = 0;
+        }
     }
 }
 
@@ -952,8 +938,286 @@ void process_set_alarm_state_state() {
     // Check input.
     // Up/Down buttons do nothing.
     // If Select button is pressed, switch to the 'show time' state.
-    if (((~GPIOA->IDR) & IOA_BUTTON_SELECT) &&
-        !(last_button_state & IOA_BUTTON_SELECT)) {
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
         cur_state = VVC_STATE_SHOW_TIME;
     }
 }
+
+#ifdef VVC_DIAGNOSTICS
+/*
+ * Process the 'diagnostics' state: RTC vs. HSE drift statistics.
+ */
+void process_diagnostics_state() {
+    char line[24];
+    int len;
+    rtc_stats_t stats;
+    rtc_stats_summary_t summary;
+    rtc_stats_snapshot(&stats);
+    rtc_stats_summary(&stats, &summary);
+
+    // Uptime, as 'up <days>d hh:mm:ss'.
+    unsigned int up = stats.uptime_s;
+    unsigned int days = 0;
+    while (up >= RTC_SECONDS_PER_DAY) {
+        up -= RTC_SECONDS_PER_DAY;
+        ++days;
+    }
+    len = fmt_text(line, "up ");
+    len += fmt_int(&line[len], days, 1);
+    len += fmt_text(&line[len], "d ");
+    len += fmt_int(&line[len], up / 3600, 2);
+    line[len++] = ':';
+    len += fmt_int(&line[len], (up / 60) % 60, 2);
+    line[len++] = ':';
+    len += fmt_int(&line[len], up % 60, 2);
+    oled_draw_small_text(4, 3, line, 1);
+
+    // Mean drift, or a warning if the 1Hz input is missing.
+    // (The small font has no 'q' or 'w'.)
+    if (!rtc_stats_sqw_ok()) {
+        fmt_text(line, "drift: no edges");
+    }
+    else {
+        len = fmt_text(line, "drift ");
+        len += fmt_int(&line[len], summary.mean_ppb, 1);
+        fmt_text(&line[len], "ppb");
+    }
+    oled_draw_small_text(4, 13, line, 1);
+
+    // Variance and spread of the per-second deviation, in us.
+    len = fmt_text(line, "var ");
+    fmt_q8(&line[len], summary.var_q8);
+    oled_draw_small_text(4, 23, line, 1);
+    len = fmt_text(line, "min ");
+    len += fmt_int(&line[len], summary.min_dev, 1);
+    len += fmt_text(&line[len], " max ");
+    fmt_int(&line[len], summary.max_dev, 1);
+    oled_draw_small_text(4, 33, line, 1);
+
+    // Sample count and thrown-out intervals.
+    len = fmt_text(line, "n ");
+    len += fmt_int(&line[len], summary.samples, 1);
+    len += fmt_text(&line[len], " lost ");
+    fmt_int(&line[len], stats.outliers, 1);
+    oled_draw_small_text(4, 43, line, 1);
+
+    // Time set corrections: count, and the last step in seconds.
+    len = fmt_text(line, "resync ");
+    len += fmt_int(&line[len], stats.resyncs, 1);
+    if (stats.resyncs) {
+        line[len++] = ' ';
+        len += fmt_int(&line[len], stats.last_resync_s, 1);
+        fmt_text(&line[len], "s");
+    }
+    oled_draw_small_text(4, 53, line, 1);
+
+    // Check input.
+    // Up/Down buttons flip to the input latency or power page.
+    // If Select button is pressed, switch to the 'show time' state.
+    if (input_frame.pressed & IOA_BUTTON_UP) {
+        cur_state = VVC_STATE_LATENCY;
+    }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        cur_state = VVC_STATE_POWER;
+    }
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
+        cur_state = VVC_STATE_SHOW_TIME;
+    }
+}
+
+/*
+ * Process the 'latency' state: time from a button edge until the
+ * press has been handled, the frame drawn, and sent to the OLED, in ms.
+ * (The press which opened this page is the latest sample.)
+ */
+void process_latency_state() {
+    static const char* stage_names[LATENCY_NUM_STAGES] = {
+        "state ", "frame ", "i2c   "
+    };
+    char line[24];
+    int len;
+    int i;
+    latency_stats_t stats;
+    latency_snapshot(&stats);
+
+    fmt_text(line, "latency  min avg max");
+    oled_draw_small_text(4, 3, line, 1);
+    for (i = 0; i < LATENCY_NUM_STAGES; ++i) {
+        len = fmt_text(line, stage_names[i]);
+        len += fmt_ms(&line[len], stats.stages[i].min_us);
+        line[len++] = ' ';
+        len += fmt_ms(&line[len], latency_avg_us(&stats, i));
+        line[len++] = ' ';
+        fmt_ms(&line[len], stats.stages[i].max_us);
+        oled_draw_small_text(4, 13+(i*10), line, 1);
+    }
+
+    // Sample count, and a histogram of the whole edge-to-i2c time.
+    // (Bars for <4ms, <8ms, ... <262ms and slower, scaled to fit.)
+    len = fmt_text(line, "n ");
+    fmt_int(&line[len], stats.samples, 1);
+    oled_draw_small_text(4, 48, line, 1);
+    unsigned int tallest = 1;
+    for (i = 0; i < LATENCY_HIST_BUCKETS; ++i) {
+        if (stats.hist[i] > tallest) { tallest = stats.hist[i]; }
+    }
+    for (i = 0; i < LATENCY_HIST_BUCKETS; ++i) {
+        int h = (stats.hist[i] * 16) / tallest;
+        if (stats.hist[i] && !h) { h = 1; }
+        if (h) {
+            oled_draw_rect(52+(i*9), 60-h, 7, h, 0, 1);
+        }
+        oled_draw_h_line(52+(i*9), 60, 7, 1);
+    }
+
+    // Check input.
+    // Up/Down buttons flip to the power or RTC page.
+    // If Select button is pressed, switch to the 'show time' state.
+    if (input_frame.pressed & IOA_BUTTON_UP) {
+        cur_state = VVC_STATE_POWER;
+    }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        cur_state = VVC_STATE_DIAGNOSTICS;
+    }
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
+        cur_state = VVC_STATE_SHOW_TIME;
+    }
+}
+
+/*
+ * Process the 'power' state: how the clock idles. The share of its
+ * running time spent in Sleep mode, how often it went into Stop mode
+ * and what woke it, and what waking up costs in ms: restarting the
+ * PLL, and until the first frame was on the OLED.
+ */
+void process_power_state() {
+    char line[24];
+    int len;
+    power_stats_t stats;
+    power_snapshot(&stats);
+
+    unsigned int permille = power_sleep_permille(&stats);
+    len = fmt_text(line, "sleep ");
+    len += fmt_int(&line[len], permille / 10, 1);
+    line[len++] = '.';
+    len += fmt_int(&line[len], permille % 10, 1);
+    fmt_text(&line[len], " pct");
+    oled_draw_small_text(4, 3, line, 1);
+    len = fmt_text(line, "stop ");
+    fmt_int(&line[len], stats.stops, 1);
+    oled_draw_small_text(4, 13, line, 1);
+    len = fmt_text(line, "by rtc ");
+    len += fmt_int(&line[len], stats.rtc_wakes, 1);
+    len += fmt_text(&line[len], " btn ");
+    fmt_int(&line[len], stats.button_wakes, 1);
+    oled_draw_small_text(4, 23, line, 1);
+
+    fmt_text(line, "resume   min avg max");
+    oled_draw_small_text(4, 33, line, 1);
+    len = fmt_text(line, "pll   ");
+    len += fmt_ms(&line[len], stats.restore.min_us);
+    line[len++] = ' ';
+    len += fmt_ms(&line[len], power_avg_us(&stats, &stats.restore));
+    line[len++] = ' ';
+    fmt_ms(&line[len], stats.restore.max_us);
+    oled_draw_small_text(4, 43, line, 1);
+    len = fmt_text(line, "frame ");
+    len += fmt_ms(&line[len], stats.frame.min_us);
+    line[len++] = ' ';
+    len += fmt_ms(&line[len], power_avg_us(&stats, &stats.frame));
+    line[len++] = ' ';
+    fmt_ms(&line[len], stats.frame.max_us);
+    oled_draw_small_text(4, 53, line, 1);
+
+    // Check input.
+    // Up/Down buttons flip to the RTC or input latency page.
+    // If Select button is pressed, switch to the 'show time' state.
+    if (input_frame.pressed & IOA_BUTTON_UP) {
+        cur_state = VVC_STATE_DIAGNOSTICS;
+    }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        cur_state = VVC_STATE_LATENCY;
+    }
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
+        cur_state = VVC_STATE_SHOW_TIME;
+    }
+}
+
+#endif
+
+/*
+ * Process the 'set brightness' state: 7-segment day/night brightness
+ * levels, and the hours which count as night.
+ */
+void process_set_brightness_state() {
+    brightness_schedule_t* sched = brightness_schedule();
+    char line[20];
+    int len;
+
+    // Draw 'Brightness' along the top.
+    char brightness_buffer[11] = { 'B', 'r', 'i', 'g', 'h',
+                                   't', 'n', 'e', 's', 's', '\0' };
+    oled_draw_small_text(34, 4, brightness_buffer, 1);
+    oled_draw_h_line(0, 14, 127, 1);
+
+    // Draw the 4 settings, and a chevron on the one being set.
+    len = fmt_text(line, "Day level   ");
+    fmt_int(&line[len], sched->day_level, 2);
+    oled_draw_small_text(16, 18, line, 1);
+    len = fmt_text(line, "Night level ");
+    fmt_int(&line[len], sched->night_level, 2);
+    oled_draw_small_text(16, 28, line, 1);
+    len = fmt_text(line, "Night from  ");
+    len += fmt_int(&line[len], BCD_TENS(sched->night_start), 1);
+    len += fmt_int(&line[len], BCD_ONES(sched->night_start), 1);
+    fmt_text(&line[len], ":00");
+    oled_draw_small_text(16, 38, line, 1);
+    len = fmt_text(line, "Night to    ");
+    len += fmt_int(&line[len], BCD_TENS(sched->night_end), 1);
+    len += fmt_int(&line[len], BCD_ONES(sched->night_end), 1);
+    fmt_text(&line[len], ":00");
+    oled_draw_small_text(16, 48, line, 1);
+    oled_draw_small_letter(6, 18+(cursor_position*10), '>', 1);
+
+    // Preview the level being set on the digits themselves.
+    if (cursor_position == 1) {
+        seven_seg_set_brightness(sched->night_level);
+    }
+    else {
+        seven_seg_set_brightness(sched->day_level);
+    }
+
+    // Check input.
+    // Up/Down buttons change the current setting.
+    int delta = 0;
+    if (input_frame.pressed & IOA_BUTTON_UP) {
+        delta = 1;
+    }
+    else if (input_frame.pressed & IOA_BUTTON_DOWN) {
+        delta = -1;
+    }
+    if (delta) {
+        if (cursor_position < 2) {
+            unsigned char* level = (cursor_position == 0) ?
+                &sched->day_level : &sched->night_level;
+            // (Don't allow 'off'; the digits are the preview.)
+            if (delta > 0 && *level < SEVEN_SEG_BRIGHTNESS_MAX) { ++*level; }
+            if (delta < 0 && *level > 1) { --*level; }
+        }
+        else {
+            unsigned char* hour = (cursor_position == 2) ?
+                &sched->night_start : &sched->night_end;
+            if (delta > 0) { *hour = bcd_inc(*hour, BCD_WRAP_HOURS); }
+            else { *hour = bcd_dec(*hour, BCD_WRAP_HOURS); }
+        }
+    }
+    // If Select button is pressed, move to the next setting, or go
+    // back to the 'show time' state after the last one.
+    if (input_frame.pressed & IOA_BUTTON_SELECT) {
+        if (cursor_position < 3) { ++cursor_position; }
+        else {
+            cur_state = VVC_STATE_SHOW_TIME;
+            cursor_position = 0;
+        }
+    }
+}
@@ -2,6 +2,19 @@
 #define _VVC_UTIL_C_H
 
 #include "global.h"
+#include "ds3231_cache.h"
+#include "bcd.h"
+#include "rtc_calib.h"
+#include "rtc_stats.h"
+#include "seven_seg.h"
+#include "seven_seg_anim.h"
+#include "buzzer.h"
+#include "tone.h"
+#include "brightness.h"
+#include "snooze.h"
+#include "input.h"
+#include "latency.h"
+#include "power.h"
 
 // OLED framebuffer drawing functions.
 void oled_clear_screen(unsigned char color);
@@ -14,6 +27,20 @@ void oled_draw_small_letter(int x, int y, char c, unsigned char color);
 void oled_draw_small_text(int x, int y, char* cc, unsigned char color);
 void oled_draw_big_letter(int x, int y, char c, unsigned char color);
 void oled_draw_big_text(int x, int y, char* cc, unsigned char color);
+int fmt_int(char* buf, int val, int min_digits);
+int fmt_q8(char* buf, unsigned int val_q8);
+int fmt_ms(char* buf, unsigned int us);
+int fmt_text(char* buf, const char* text);
+
+// Last line of menu page 2. (The 'Diagnostics' line, with the drift,
+// latency and power pages behind it, is only in 'make DIAGNOSTICS=1'
+// builds; they don't fit in an STM32F030F4's 16KB along with the
+// rest.)
+#ifdef VVC_DIAGNOSTICS
+#define MENU_PAGE_2_LAST 2
+#else
+#define MENU_PAGE_2_LAST 1
+#endif
 
 // Alarm clock state management functions.
 void process_show_time_state();
@@ -25,5 +52,12 @@ void process_set_alarm_state();
 void process_set_alarm_days_state();
 void process_set_alarm_tone_state();
 void process_set_alarm_state_state();
+void process_menu_page_3_state();
+void process_set_brightness_state();
+#ifdef VVC_DIAGNOSTICS
+void process_diagnostics_state();
+void process_latency_state();
+void process_power_state();
+#endif
 
 #endif
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+Convert a WAV file into a 4-bit IMA ADPCM clip for the audio engine.
+(See src/audio.h; only built with 'make AUDIO=1'.)
+
+The input can be any PCM WAV (8/16-bit, mono or stereo, any rate);
+it is mixed down to mono and resampled to the engine's 8KHz rate.
+The output is a C header with the packed nibbles (first sample in
+the low nibble) and the sample count:
+
+    python3 tools/wav2adpcm.py chirp.wav birds > src/audio_clip_birds.h
+
+The decoder starts every clip from a predictor of 0 and step index 0,
+so this encoder does too.
+"""
+import sys
+import wave
+import struct
+
+SAMPLE_HZ = 8000
+
+STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+    41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+    190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+    6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289,
+    16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+INDEX_ADJ = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_wav(path):
+    w = wave.open(path, 'rb')
+    channels = w.getnchannels()
+    width = w.getsampwidth()
+    rate = w.getframerate()
+    raw = w.readframes(w.getnframes())
+    w.close()
+    if width == 1:
+        vals = [(b - 128) << 8 for b in raw]
+    elif width == 2:
+        vals = list(struct.unpack('<%dh' % (len(raw) // 2), raw))
+    else:
+        sys.exit('only 8-bit and 16-bit PCM WAVs are supported')
+    mono = [sum(vals[i:i + channels]) // channels
+            for i in range(0, len(vals), channels)]
+    return mono, rate
+
+
+def resample(samples, rate):
+    # Linear interpolation is plenty for a buzzer.
+    if rate == SAMPLE_HZ:
+        return samples
+    n = int(len(samples) * SAMPLE_HZ / rate)
+    out = []
+    for i in range(n):
+        pos = i * rate / SAMPLE_HZ
+        j = int(pos)
+        frac = pos - j
+        a = samples[min(j, len(samples) - 1)]
+        b = samples[min(j + 1, len(samples) - 1)]
+        out.append(int(a + (b - a) * frac))
+    return out
+
+
+def encode(samples):
+    pred = 0
+    index = 0
+    nibbles = []
+    for s in samples:
+        step = STEPS[index]
+        diff = s - pred
+        nib = 0
+        if diff < 0:
+            nib = 8
+            diff = -diff
+        if diff >= step:
+            nib |= 4
+            diff -= step
+        if diff >= step >> 1:
+            nib |= 2
+            diff -= step >> 1
+        if diff >= step >> 2:
+            nib |= 1
+        # Track the decoder's reconstruction, not the input.
+        delta = step >> 3
+        if nib & 1:
+            delta += step >> 2
+        if nib & 2:
+            delta += step >> 1
+        if nib & 4:
+            delta += step
+        pred = pred - delta if nib & 8 else pred + delta
+        pred = max(-32768, min(32767, pred))
+        index = max(0, min(88, index + INDEX_ADJ[nib & 7]))
+        nibbles.append(nib)
+    if len(nibbles) & 1:
+        nibbles.append(0)
+    return bytes(nibbles[i] | (nibbles[i + 1] << 4)
+                 for i in range(0, len(nibbles), 2))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit('usage: wav2adpcm.py <in.wav> <name>')
+    path, name = sys.argv[1], sys.argv[2]
+    samples = resample(*read_wav(path))
+    data = encode(samples)
+    guard = '_VVC_AUDIO_CLIP_%s_H' % name.upper()
+    print('#ifndef %s' % guard)
+    print('#define %s' % guard)
+    print('')
+    print('// Generated by tools/wav2adpcm.py from %s.' % path.split('/')[-1])
+    print('// %d samples at %dHz, 4-bit IMA ADPCM.' % (len(samples), SAMPLE_HZ))
+    print('#define AUDIO_CLIP_%s_SAMPLES %d' % (name.upper(), len(samples)))
+    print('static const unsigned char audio_clip_%s_data[%d] = {'
+          % (name, len(data)))
+    for i in range(0, len(data), 12):
+        row = ', '.join('0x%02X' % b for b in data[i:i + 12])
+        print('    %s,' % row)
+    print('};')
+    print('')
+    print('#endif')
+
+
+if __name__ == '__main__':
+    main()